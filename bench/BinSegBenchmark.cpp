@@ -0,0 +1,336 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "Distributions.h"
+#include "Algorithms.h"
+#include "StreamSegmenter.h"
+
+// Benchmarks of the engine without R. Every benchmark is run on synthetic piecewise data, whose changes depend on the
+// distribution, for n = 1e4, 1e5, ... up to --max-n datapoints and K = 1, 10, ... up to --max-k changepoints. For each
+// case, the minimum and median times of several repetitions are reported, together with a checksum of the results so
+// that the work can not be optimized away and different builds can be compared. The sliding window cases segment a
+// window of n datapoints after each of 20 slides of n / 100 new datapoints, either removing the oldest datapoints from
+// the summary statistics (window_slide) or computing them again for every window (window_rebuild). A second table
+// validates the approximate search of the best split: the fraction of random segments where it agrees with the exact
+// search, for strides of 10, 100 and 1000 (with a window equal to the stride), and its speedup. A third table compares
+// the vectorized split scan (see SplitScan) with the scalar one: the fraction of random segments where both select the
+// same split, the largest relative difference of their decreases in cost, and the speedup of the vectorized scan.
+//
+// Usage: binseg_benchmark [--quick] [--max-n N] [--max-k K] [--min-time SECONDS] [--csv]
+
+struct Options {
+    long maxN = 1000000;
+    int maxK = 1000;
+    double minTime = 0.5; // The repetitions of a case stop once they add up to this many seconds
+    int maxReps = 25;
+    bool csv = false;
+};
+
+struct Result {
+    std::vector<double> times;
+    double checksum = 0;
+};
+
+static const char * univariateDistributions[] = {"mean_norm", "var_norm", "meanvar_norm", "negbin", "poisson",
+                                                 "exponential"};
+static const char * vectorizedDistributions[] = {"mean_norm", "meanvar_norm", "poisson", "exponential"};
+
+// Generates n datapoints with numChanges changes at random positions. Each segment draws its parameters at random, and
+// then the observations from the family that the distribution models, so that every distribution finds real changes.
+std::vector<double> piecewise_data(const std::string &distribution, long n, int numChanges, unsigned seed){
+    std::mt19937_64 gen(seed);
+    std::vector<long> ends;
+    std::uniform_int_distribution<long> position(1, n - 1);
+    for (int i = 0; i < numChanges && i < n - 1; i++) ends.push_back(position(gen));
+    ends.push_back(n);
+    std::sort(ends.begin(), ends.end());
+
+    std::vector<double> data(n);
+    std::uniform_real_distribution<double> level(-5, 5), scale(0.5, 3), rate(1, 20);
+    long start = 0;
+    for (long end: ends) {
+        if (distribution == "mean_norm") {
+            std::normal_distribution<double> draw(level(gen), 1);
+            for (long i = start; i < end; i++) data[i] = draw(gen);
+        } else if (distribution == "var_norm") {
+            std::normal_distribution<double> draw(0, scale(gen));
+            for (long i = start; i < end; i++) data[i] = draw(gen);
+        } else if (distribution == "meanvar_norm") {
+            std::normal_distribution<double> draw(level(gen), scale(gen));
+            for (long i = start; i < end; i++) data[i] = draw(gen);
+        } else if (distribution == "negbin") {
+            std::negative_binomial_distribution<int> draw(5, 1 / scale(gen));
+            for (long i = start; i < end; i++) data[i] = draw(gen);
+        } else if (distribution == "poisson") {
+            std::poisson_distribution<int> draw(rate(gen));
+            for (long i = start; i < end; i++) data[i] = draw(gen);
+        } else {
+            std::exponential_distribution<double> draw(1 / rate(gen));
+            for (long i = start; i < end; i++) data[i] = draw(gen);
+        }
+        start = end;
+    }
+    return data;
+}
+
+// Runs the case until it takes the minimum time or the maximum number of repetitions, at least once. The case returns a
+// value that is added to the checksum.
+template<class F>
+Result measure(const Options &options, F run){
+    Result result;
+    double total = 0;
+    do {
+        auto begin = std::chrono::steady_clock::now();
+        double value = run();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        result.times.push_back(elapsed.count());
+        result.checksum += value;
+        total += elapsed.count();
+    } while (total < options.minTime && (int) result.times.size() < options.maxReps);
+    std::sort(result.times.begin(), result.times.end());
+    result.checksum /= result.times.size();
+    return result;
+}
+
+void report(const Options &options, const char * benchmark, const std::string &distribution, long n, int K,
+            const Result &result){
+    double best = result.times.front() * 1e3, median = result.times[result.times.size() / 2] * 1e3;
+    const char * format = options.csv ? "%s,%s,%ld,%d,%zu,%.4f,%.4f,%.10g\n" :
+                          "%-18s %-14s %10ld %6d %5zu %14.4f %14.4f %20.10g\n";
+    printf(format, benchmark, distribution.c_str(), n, K, result.times.size(), best, median, result.checksum);
+    fflush(stdout);
+}
+
+// The summary statistics of the data, which every algorithm computes once before the search.
+void bench_cumsum(const Options &options, long n){
+    std::vector<double> data = piecewise_data("meanvar_norm", n, 10, 1);
+    Result result = measure(options, [&](){
+        CumsumSquared statistics;
+        statistics.init(data.data(), n);
+        return statistics.getMean(0, n - 1) + statistics.getVarianceN(0, n - 1, true);
+    });
+    report(options, "cumsum_init", "meanvar_norm", n, 0, result);
+}
+
+// The scan over every split of a single segment, which dominates the first iterations of any algorithm.
+void bench_partition(const Options &options, const std::string &distribution, long n){
+    std::vector<double> data = piecewise_data(distribution, n, 10, 2);
+    std::shared_ptr<Distribution> dist = DistributionFactory::Create(distribution);
+    dist -> setCumsum();
+    dist -> useStableSums();
+    dist -> setData(data.data(), n);
+    int minSegLen = distribution == "mean_norm" ? 1 : 2;
+    Result result = measure(options, [&](){
+        Segment segment(0, n - 1, dist.get(), minSegLen, 0, 0);
+        segment.optimalPartition();
+        return segment.mid + segment.bestDecrease;
+    });
+    report(options, "optimal_partition", distribution, n, 1, result);
+}
+
+// A complete run of Binary Segmentation, including the summary statistics and the parameters of every model.
+void bench_binseg(const Options &options, long n, int K){
+    std::vector<double> data = piecewise_data("meanvar_norm", n, K, 3);
+    Result result = measure(options, [&](){
+        std::shared_ptr<Distribution> dist = DistributionFactory::Create("meanvar_norm");
+        std::shared_ptr<Algorithm> algo = AlgorithmFactory::Create("BS");
+        dist -> setCumsum();
+        dist -> useStableSums();
+        algo -> init(data.data(), n, K, dist, 2);
+        algo -> run();
+        ModelTable &models = algo -> models;
+        double sum = models.getNumRows();
+        for (int i = 0; i < models.getNumRows(); i++) sum += models.row(i)[1];
+        return sum;
+    });
+    report(options, "binseg", "meanvar_norm", n, K, result);
+}
+
+// Segments a sliding window of n datapoints after each of 20 slides, with a stream that removes the oldest datapoints
+// from the summary statistics (see StreamSegmenter::setWindow), or by running the algorithm again on every window.
+void bench_window(const Options &options, long n, int K, bool rebuild){
+    long step = n / 100, slides = 20;
+    std::vector<double> data = piecewise_data("meanvar_norm", n + slides * step, K, 6);
+    Result result = measure(options, [&](){
+        double sum = 0;
+        StreamSegmenter stream("BS", "meanvar_norm", K, 2, true);
+        stream.setWindow(n);
+        for (long k = 0; k <= slides; k++) {
+            long first = k * step;
+            if (rebuild) {
+                std::shared_ptr<Distribution> dist = DistributionFactory::Create("meanvar_norm");
+                std::shared_ptr<Algorithm> algo = AlgorithmFactory::Create("BS");
+                dist -> setCumsum();
+                dist -> useStableSums();
+                algo -> init(data.data() + first, n, K, dist, 2);
+                algo -> run();
+                sum += algo -> models.row(algo -> models.getNumRows() - 1)[1];
+            } else {
+                if (k == 0) stream.append(data.data(), n);
+                else stream.append(data.data() + first + n - step, step);
+                stream.segment();
+                sum += stream.getModels().row(stream.getModels().getNumRows() - 1)[1];
+            }
+        }
+        return sum;
+    });
+    report(options, rebuild ? "window_rebuild" : "window_slide", "meanvar_norm", n, K, result);
+}
+
+// The agreement of the approximate search (see Distribution::approximateSplit) with the exact one, over random segments
+// of the data, and the speedup of the approximate search over those segments.
+void bench_approximate(const Options &options, const std::string &distribution, long n, int stride){
+    std::vector<double> data = piecewise_data(distribution, n, 10, 4);
+    std::shared_ptr<Distribution> dist = DistributionFactory::Create(distribution);
+    dist -> setCumsum();
+    dist -> useStableSums();
+    dist -> setData(data.data(), n);
+    int minSegLen = distribution == "mean_norm" ? 1 : 2;
+
+    std::mt19937_64 gen(5);
+    std::uniform_int_distribution<long> position(0, n - 1);
+    std::vector<std::pair<int, int>> segments;
+    while (segments.size() < 100) {
+        long start = position(gen), end = position(gen);
+        if (start > end) std::swap(start, end);
+        if (end - start >= 4 * stride) segments.push_back({(int) start, (int) end});
+    }
+
+    std::vector<int> exactMids(segments.size()), approximateMids(segments.size());
+    auto search = [&](int searchStride, std::vector<int> &mids){
+        dist -> searchStride = searchStride;
+        dist -> searchWindow = stride;
+        return measure(options, [&](){
+            double sum = 0;
+            for (size_t k = 0; k < segments.size(); k++) {
+                Segment segment(segments[k].first, segments[k].second, dist.get(), minSegLen, 0, 0);
+                segment.optimalPartition();
+                mids[k] = segment.mid;
+                sum += segment.mid;
+            }
+            return sum;
+        });
+    };
+    Result exact = search(1, exactMids), approximate = search(stride, approximateMids);
+    dist -> searchStride = 1;
+
+    int agreements = 0;
+    for (size_t k = 0; k < segments.size(); k++) agreements += exactMids[k] == approximateMids[k];
+    double speedup = exact.times.front() / approximate.times.front();
+    const char * format = options.csv ? "%s,%s,%ld,%d,%d,%.4f,%.4f\n" : "%-18s %-14s %10ld %6d %6d %10.4f %10.4f\n";
+    printf(format, "approximate_split", distribution.c_str(), n, stride, stride,
+           (double) agreements / segments.size(), speedup);
+    fflush(stdout);
+}
+
+// The agreement of the vectorized split scan with the scalar one, over random segments of the data, and the speedup of
+// the vectorized scan over those segments. The scalar scan is selected by limiting the instruction set of SplitScan.
+void bench_simd(const Options &options, const std::string &distribution, long n){
+    std::vector<double> data = piecewise_data(distribution, n, 10, 7);
+    std::shared_ptr<Distribution> dist = DistributionFactory::Create(distribution);
+    dist -> setCumsum();
+    dist -> useStableSums();
+    dist -> setData(data.data(), n);
+    int minSegLen = distribution == "mean_norm" ? 1 : 2;
+
+    std::mt19937_64 gen(8);
+    std::uniform_int_distribution<long> position(0, n - 1);
+    std::vector<std::pair<int, int>> segments;
+    while (segments.size() < 100) {
+        long start = position(gen), end = position(gen);
+        if (start > end) std::swap(start, end);
+        if (end - start >= n / 10) segments.push_back({(int) start, (int) end});
+    }
+
+    std::vector<int> scalarMids(segments.size()), simdMids(segments.size());
+    std::vector<double> scalarCosts(segments.size()), simdCosts(segments.size());
+    auto search = [&](SimdLevel level, std::vector<int> &mids, std::vector<double> &costs){
+        SplitScan::limit(level);
+        return measure(options, [&](){
+            double sum = 0;
+            for (size_t k = 0; k < segments.size(); k++) {
+                Segment segment(segments[k].first, segments[k].second, dist.get(), minSegLen, 0, 0);
+                segment.optimalPartition();
+                mids[k] = segment.mid;
+                costs[k] = segment.bestDecrease;
+                sum += segment.mid;
+            }
+            return sum;
+        });
+    };
+    Result scalar = search(SCALAR_LEVEL, scalarMids, scalarCosts);
+    Result simd = search(AVX512_LEVEL, simdMids, simdCosts);
+
+    int agreements = 0;
+    double maxDifference = 0;
+    for (size_t k = 0; k < segments.size(); k++) {
+        agreements += scalarMids[k] == simdMids[k];
+        double scale = std::max(fabs(scalarCosts[k]), 1.0);
+        maxDifference = std::max(maxDifference, fabs(scalarCosts[k] - simdCosts[k]) / scale);
+    }
+    double speedup = scalar.times.front() / simd.times.front();
+    const char * format = options.csv ? "%s,%s,%ld,%s,%.4f,%.3g,%.4f\n" :
+                          "%-18s %-14s %10ld %8s %10.4f %10.3g %10.4f\n";
+    const char * levels[] = {"scalar", "avx2", "avx512"};
+    printf(format, "simd_scan", distribution.c_str(), n, levels[SplitScan::level()],
+           (double) agreements / segments.size(), maxDifference, speedup);
+    fflush(stdout);
+}
+
+int main(int argc, char ** argv){
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--quick")) {
+            options.maxN = 10000;
+            options.maxK = 10;
+            options.minTime = 0;
+            options.maxReps = 1;
+        } else if (!strcmp(argv[i], "--max-n") && i + 1 < argc) options.maxN = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--max-k") && i + 1 < argc) options.maxK = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--min-time") && i + 1 < argc) options.minTime = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--csv")) options.csv = true;
+        else {
+            fprintf(stderr, "Usage: %s [--quick] [--max-n N] [--max-k K] [--min-time SECONDS] [--csv]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (options.maxN < 10000 || options.maxN > 100000000) {
+        fprintf(stderr, "The maximum number of datapoints must be between 1e4 and 1e8\n");
+        return 1;
+    }
+
+    const char * header = options.csv ? "%s,%s,%s,%s,%s,%s,%s,%s\n" : "%-18s %-14s %10s %6s %5s %14s %14s %20s\n";
+    printf(header, "benchmark", "distribution", "n", "K", "reps", "min_ms", "median_ms", "checksum");
+    try {
+        for (long n = 10000; n <= options.maxN; n *= 10) bench_cumsum(options, n);
+        for (const char * distribution: univariateDistributions)
+            for (long n = 10000; n <= options.maxN; n *= 10) bench_partition(options, distribution, n);
+        for (long n = 10000; n <= options.maxN; n *= 10)
+            for (int K = 1; K <= options.maxK && K < n / 10; K *= 10) bench_binseg(options, n, K);
+        for (long n = 10000; n <= options.maxN; n *= 10)
+            for (bool rebuild: {false, true}) bench_window(options, n, 10, rebuild);
+
+        const char * approximateHeader = options.csv ? "%s,%s,%s,%s,%s,%s,%s\n" :
+                                         "\n%-18s %-14s %10s %6s %6s %10s %10s\n";
+        printf(approximateHeader, "benchmark", "distribution", "n", "stride", "window", "agreement", "speedup");
+        for (const char * distribution: univariateDistributions)
+            for (long n = 10000; n <= options.maxN; n *= 10)
+                for (int stride = 10; stride <= 1000 && 4 * stride < n; stride *= 10)
+                    bench_approximate(options, distribution, n, stride);
+
+        const char * simdHeader = options.csv ? "%s,%s,%s,%s,%s,%s,%s\n" : "\n%-18s %-14s %10s %8s %10s %10s %10s\n";
+        printf(simdHeader, "benchmark", "distribution", "n", "level", "agreement", "max_diff", "speedup");
+        for (const char * distribution: vectorizedDistributions)
+            for (long n = 10000; n <= options.maxN; n *= 10) bench_simd(options, distribution, n);
+    } catch (const char * message) {
+        fprintf(stderr, "%s\n", message);
+        return 1;
+    }
+    return 0;
+}
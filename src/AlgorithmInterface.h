@@ -0,0 +1,396 @@
+//
+// Created by Diego Urgell on 16/06/21.
+//
+
+#ifndef BINSEG_ALGORITHM_INTERFACE_H
+#define BINSEG_ALGORITHM_INTERFACE_H
+
+#include <map>
+#include <algorithm>
+#include <functional>
+#include "DistributionInterface.h"
+#include "CandidateQueue.h"
+#include "SegmentCache.h"
+#include "ModelTable.h"
+#include "ThreadPool.h"
+
+typedef std::pair<int, int> Interval; // Inclusive start and end of a candidate interval
+
+/**
+ * Abstract class that is an interface to every specific algorithm based on BinarySegmentation. It contains the basic
+ * attributes as the distribution, the queue of candidate segments, and the vector of changepoints.
+ */
+class Algorithm{
+
+protected:
+
+    static const int initialCapacity = 1024; // The number of models that memory is reserved for in advance
+
+public:
+
+    std::shared_ptr<Distribution> dist;
+    CandidateQueue candidates;
+    std::shared_ptr<ThreadPool> pool;
+    std::shared_ptr<SegmentCache> cache; // Optional, reuses the partitions of a previous run over the same data
+    std::shared_ptr<RunCounters> counters; // Optional, the performance counters of the run (see setCounters)
+    std::function<bool(int)> checkpoint; // Optional, called between the iterations (see setCheckpoint)
+    bool interrupted = false;
+    int length, numCpts, minSegLen;
+    int numIntervals = 5000, seed = 0;
+    double penalty = -INFINITY; // Disabled
+    ModelTable models;
+    int completedRows = 0; // The rows of the models table that are already completed (see completeModels)
+    double lastCost = 0; // The partial cost of the last model, before it is completed
+
+public:
+
+    Algorithm() = default;
+
+    virtual ~Algorithm() = default;
+
+    /**
+     * This initialization method copies the necessary data into the class' attributes in order to use them later on
+     * in the binseg method.
+     * @param data The vector of data, given by the user. Used to initialize the summaryStatisticss.
+     * @param length The length of the data vector
+     * @param numCpts  The number of changepoints to be computed
+     * @param dist The distribution pointer to compute the costs.
+     * @param minSegLen The minimum segment length.
+     */
+    void init(const double *data, int length, int numCpts, std::shared_ptr<Distribution> dist, int minSegLen){
+        dist -> counters = this -> counters;
+        dist -> setData(data, length);
+        this -> prepare(length, numCpts, dist, minSegLen);
+    }
+
+    /**
+     * Same as init, but the summary statistics of the distribution must already hold the data. It is used to run the
+     * algorithm again after new observations are appended to them.
+     */
+    void prepare(int length, int numCpts, std::shared_ptr<Distribution> dist, int minSegLen){
+        this -> dist = dist;
+        this -> interrupted = false;
+        this -> dist -> counters = this -> counters;
+        this -> candidates.counters = this -> counters.get();
+        this -> length = length;
+        this -> numCpts = numCpts;
+        this -> minSegLen = minSegLen;
+        // With a penalty, numCpts is only an upper bound, so the memory is not reserved beyond the initial size.
+        int expectedCpts = std::min(numCpts, initialCapacity);
+        this -> models.reset(dist -> getParamCount() + 5, expectedCpts + 1);
+        this -> completedRows = 0;
+        this -> candidates.clear();
+        this -> candidates.reserve(2 * expectedCpts + 1);
+    }
+
+    /**
+     * Whether the algorithm can continue a previous run to find more changepoints (see resume). It is the case when the
+     * changepoints of a run are always the first ones of a run with more changepoints, and the state of the search is
+     * kept between runs.
+     */
+    virtual bool isResumable(){
+        return false;
+    }
+
+    /**
+     * Prepares the algorithm to continue the previous run, keeping its models, its candidate segments and the summary
+     * statistics of the data. Then, run only computes the changepoints after the ones that were already found. It is
+     * only valid if isResumable, and the performance counters must be set before calling it, as for prepare.
+     * @param numCpts The new number of changepoints. It must not be smaller than the previous one.
+     */
+    void resume(int numCpts){
+        this -> interrupted = false;
+        this -> dist -> counters = this -> counters;
+        this -> candidates.counters = this -> counters.get();
+        this -> numCpts = numCpts;
+    }
+
+    /**
+     * Updates the models of the previous run after new observations are appended to the summary statistics of the
+     * distribution, instead of running the algorithm again from the start. The result must be the same as the one of a
+     * new run over the whole data. The models table is completed, as after run.
+     * @param length The new length of the data.
+     * @return false if the algorithm can not update its previous run, in which case nothing is changed and it must run
+     * again (see prepare).
+     */
+    virtual bool extend(int length){
+        (void) length;
+        return false;
+    }
+
+    /**
+     * Enables the parallel search. Segments with more than parallelThreshold candidate splits are scanned in chunks by
+     * numThreads threads, and the new segments created at each iteration are evaluated concurrently. It must be called
+     * after init, since it shares the thread pool with the distribution.
+     * @param numThreads The number of threads. If it is 1, the algorithm runs on the calling thread only.
+     * @param parallelThreshold The minimum number of candidate splits to scan a segment in parallel.
+     */
+    void setParallelism(int numThreads, int parallelThreshold){
+        this -> pool = numThreads > 1 ? std::make_shared<ThreadPool>(numThreads) : nullptr;
+        this -> dist -> pool = this -> pool;
+        this -> dist -> parallelThreshold = parallelThreshold;
+    }
+
+    /**
+     * Enables the approximate search of the best split of each segment (see Distribution::approximateSplit). It must be
+     * called after init, and it is exact if the stride is 1.
+     * @param stride The distance between the candidate splits of the coarse search.
+     * @param window The number of candidates at each side of the best one of the coarse search that are scanned exactly.
+     */
+    void setApproximate(int stride, int window){
+        this -> dist -> searchStride = stride;
+        this -> dist -> searchWindow = window;
+    }
+
+    /**
+     * Enables the performance counters of the run (see RunCounters). It must be called before init, so that the time
+     * spent computing the summary statistics is also counted.
+     * @param counters The counters to update, or nullptr to disable them.
+     */
+    void setCounters(std::shared_ptr<RunCounters> counters){
+        this -> counters = counters;
+    }
+
+    /**
+     * Sets a function that is called between the iterations of the algorithm, with the number of changepoints found so
+     * far. If it returns true, the algorithm stops, and the models found until then are kept (see isInterrupted). It
+     * is called on the thread that runs the algorithm while no segment is being scanned, so it can check for user
+     * interrupts or report the progress of long runs.
+     * @param checkpoint The function, or an empty one to disable it.
+     */
+    void setCheckpoint(std::function<bool(int)> checkpoint){
+        this -> checkpoint = checkpoint;
+    }
+
+    /**
+     * @return Whether the last run was stopped by the checkpoint, so that the models table is only partial.
+     */
+    bool isInterrupted(){
+        return this -> interrupted;
+    }
+
+    /**
+     * Calls the checkpoint, if any, and records whether the algorithm must stop.
+     * @param numFound The number of changepoints found so far.
+     * @return Whether the algorithm must stop.
+     */
+    bool interrupt(int numFound){
+        if (!this -> checkpoint || !this -> checkpoint(numFound)) return false;
+        this -> interrupted = true;
+        return true;
+    }
+
+    /**
+     * Enables the penalized stopping rule. The algorithm stops before numCpts changepoints are found if the best
+     * decrease in cost is not larger than the penalty.
+     * @param penalty The penalty for each changepoint, on the scale of Distribution::costFunction. Use -INFINITY to
+     * disable it, so that exactly numCpts changepoints are computed whenever possible.
+     */
+    void setPenalty(double penalty){
+        this -> penalty = penalty;
+    }
+
+    /**
+     * @return Whether the penalized stopping rule is enabled.
+     */
+    bool isPenalized() const {
+        return this -> penalty != -INFINITY;
+    }
+
+    /**
+     * @return Whether a split with the given decrease in cost must not be added to the model.
+     */
+    bool stops(double decrease){
+        return this -> isPenalized() && decrease <= this -> penalty;
+    }
+
+    /**
+     * Sets the parameters of the algorithms that draw random intervals, such as Wild Binary Segmentation. Other
+     * algorithms ignore them.
+     * @param numIntervals The number of random intervals
+     * @param seed The seed of the random number generator, so that the intervals are reproducible.
+     */
+    void setRandomIntervals(int numIntervals, int seed){
+        this -> numIntervals = numIntervals;
+        this -> seed = seed;
+    }
+
+    /**
+     * Computes the optimal partition of several segments, concurrently if a thread pool is available. If there is a
+     * cache, only the segments that are not found in it are scanned, and then they are stored.
+     * @param segments The segments to evaluate.
+     * @param count The number of segments.
+     */
+    void evaluate(Segment * segments, int count){
+        if (this -> cache == nullptr){
+            this -> forEachSegment(count, [segments](int k){ segments[k].optimalPartition(); });
+            return;
+        }
+        std::vector<Segment *> pending;
+        for (int k = 0; k < count; k++)
+            if (!this -> cache -> lookup(segments[k])) pending.push_back(segments + k);
+        this -> forEachSegment(pending.size(), [&pending](int k){ pending[k] -> optimalPartition(); });
+        for (Segment * segment: pending) this -> cache -> store(*segment);
+    }
+
+    /**
+     * Runs evaluateOne(0), ..., evaluateOne(count - 1), in parallel if a thread pool is available.
+     */
+    template<class F>
+    void forEachSegment(int count, const F &evaluateOne){
+        if (this -> pool == nullptr){
+            for (int k = 0; k < count; k++) evaluateOne(k);
+            return;
+        }
+        // Each task takes every numTasks-th segment, so that segments of different lengths are spread evenly.
+        int numTasks = std::min(count, this -> pool -> size() * 8);
+        this -> pool -> parallelFor(numTasks, [&evaluateOne, count, numTasks](int task){
+            for (int k = task; k < count; k += numTasks) evaluateOne(k);
+        });
+    }
+
+    /**
+     * Stores the model without changepoints in the first row of the models table. That is, the whole data as a single
+     * segment, which does not invalidate any previous model.
+     */
+    void writeFirstModel(){
+        double * row = this -> models.addRow(0, this -> length - 1, 0);
+        row[0] = 1;
+        row[1] = this -> length;
+        row[2] = NAN;
+        row[3] = NAN;
+        row[4] = this -> dist -> modelCost(0, this -> length - 1);
+        this -> lastCost = row[4];
+    }
+
+    /**
+     * Stores the model with i changepoints in the i-th row of the models table. It is obtained by splitting the segment
+     * [start, end] of the previous model at mid. Its parameters are estimated later, by completeModels.
+     * @param i The number of changepoints of the model
+     * @param start inclusive
+     * @param mid The new changepoint
+     * @param end inclusive
+     * @param invalidatesIndex The row of the model that created the segment [start, end]
+     * @param invalidatesAfter 0 if [start, end] was the left part of that split, and 1 if it was the right part.
+     * @param decrease The decrease in cost produced by the split.
+     */
+    void writeModel(int i, int start, int mid, int end, int invalidatesIndex, int invalidatesAfter, double decrease){
+        double * row = this -> models.addRow(start, mid, end);
+        row[0] = i + 1;
+        row[1] = mid + 1;
+        row[2] = invalidatesIndex + 1;
+        row[3] = invalidatesAfter;
+        row[4] = this -> lastCost - decrease;
+        this -> lastCost = row[4];
+    }
+
+    /**
+     * Completes the models table once the changepoints are known. The parameters of every model are estimated in a
+     * single pass, and the terms of the cost that do not depend on the segmentation are added, so that the cost is the
+     * complete one. It is scaled by 2, as in the models summary of R. Only the models added since the last call are
+     * completed, so that a resumed run does not modify the previous ones.
+     */
+    void completeModels(){
+        int numRows = this -> models.getNumRows() - this -> completedRows;
+        int numCols = this -> models.getNumCols();
+        if (numRows <= 0) return;
+        double * rows = this -> models.row(this -> completedRows);
+        this -> dist -> calcModelParams(rows, numRows, numCols, this -> models.getSplits() + 3 * this -> completedRows);
+        double constant = this -> dist -> getConstant();
+        for (int i = 0; i < numRows; i++){
+            double * row = rows + (size_t) i * numCols;
+            row[4] = 2 * (row[4] + constant);
+        }
+        this -> completedRows += numRows;
+    }
+
+    /**
+     * Greedy selection of changepoints from a fixed set of candidate intervals, as used by Seeded and Wild Binary
+     * Segmentation. The best split of every interval is computed once (in parallel if a thread pool is available), and
+     * then the interval with the largest decrease in cost is repeatedly selected, as long as it does not contain a
+     * changepoint found before. The selected split is applied to the segment of the current model that contains the
+     * interval, so that the models table has exactly the same layout as in regular Binary Segmentation. With a penalty,
+     * the selection stops once the decrease of the best interval is not larger than it, and a split is skipped if its
+     * decrease on the segment that contains the interval is not larger than it.
+     * @param intervals The candidate intervals. Their order is used to resolve ties in the decrease.
+     * @param addSegments If true, the two segments created by every split are also added as candidate intervals, so
+     * that each segment of the current model can always be split (as in Wild Binary Segmentation).
+     */
+    void selectFromIntervals(const std::vector<Interval> &intervals, bool addSegments = false){
+        this -> candidates.clear();
+        this -> candidates.reserve(intervals.size() + (addSegments ? 2 * std::min(this -> numCpts, initialCapacity) : 0));
+        for (const Interval &interval: intervals)
+            this -> candidates.add(interval.first, interval.second, this -> dist.get(), this -> minSegLen, 0, 0);
+        // The intervals depend on the length of the data, so they are not looked up in the cache.
+        Segment * scanned = intervals.empty() ? nullptr : &this -> candidates[0];
+        this -> forEachSegment(intervals.size(), [scanned](int k){ scanned[k].optimalPartition(); });
+        for (int k = 0; k < (int) intervals.size(); k++) this -> candidates.push(k);
+
+        // The segments of the current model, by their start. Each one stores the model that created it, and the side.
+        std::map<int, Interval> segments;
+        segments[0] = Interval(0, 0);
+        this -> writeFirstModel();
+        int i = 1;
+        while (i <= this -> numCpts && !this -> candidates.empty()){
+            if (this -> interrupt(i - 1)) return;
+            Segment interval = this -> candidates[this -> candidates.top()];
+            if (interval.mid == 0 || this -> stops(interval.bestDecrease)) return;
+            this -> candidates.pop();
+            std::map<int, Interval>::iterator next = segments.upper_bound(interval.start);
+            if (next != segments.end() && next -> first <= interval.end) continue; // Contains a previous changepoint
+            std::map<int, Interval>::iterator current = std::prev(next);
+            int start = current -> first;
+            int end = next == segments.end() ? this -> length - 1 : next -> first - 1;
+            double decrease = this -> dist -> costFunction(start, end) -
+                    (this -> dist -> costFunction(start, interval.mid) + this -> dist -> costFunction(interval.mid + 1, end));
+            if (this -> stops(decrease)) continue; // The split decreases the cost less within the whole segment
+            this -> writeModel(i, start, interval.mid, end, current -> second.first, current -> second.second, decrease);
+            segments[start] = Interval(i, 0);
+            segments[interval.mid + 1] = Interval(i, 1);
+            if (addSegments){
+                int left = this -> candidates.add(start, interval.mid, this -> dist.get(), this -> minSegLen, 0, 0);
+                int right = this -> candidates.add(interval.mid + 1, end, this -> dist.get(), this -> minSegLen, 0, 0);
+                this -> evaluate(&this -> candidates[left], 2);
+                this -> candidates.push(left);
+                this -> candidates.push(right);
+            }
+            i++;
+        }
+    }
+
+    /**
+     * Runs the algorithm and completes the models table (see completeModels).
+     */
+    void run(){
+        this -> binseg();
+        this -> completeModels();
+        if (this -> counters != nullptr)
+            this -> counters -> bytes = this -> dist -> summaryStatistics -> getBytes() +
+                                        this -> candidates.getBytes() + this -> models.getBytes();
+    }
+
+    /**
+     * This is the most important method, that implements the algorithm per se. It must be overridden in every specific
+     * algorithm subclass. The costs of the models table are only partial until completeModels is called.
+     */
+    virtual void binseg() = 0;
+
+    virtual std::vector<std::string> getParamNames() = 0;
+
+};
+
+
+/**
+ * Instantiation of the GenericFactory template for the Algorithm interface.
+ */
+class AlgorithmFactory: public GenericFactory<Algorithm>{
+    void foo(){ (void) created; }
+};
+
+// The registered algorithms are defined once, in Registry.cpp.
+template<>
+std::map<std::string, std::shared_ptr<Algorithm>(*)()> GenericFactory<Algorithm>::regSpecs;
+template<>
+std::map<std::string, std::string> GenericFactory<Algorithm>::regDescs;
+
+#endif // BINSEG_ALGORITHM_INTERFACE_H
@@ -0,0 +1,264 @@
+//
+// Created by Diego Urgell on 10/06/21.
+//
+
+#ifndef BINSEG_ALGORITHMS_H
+#define BINSEG_ALGORITHMS_H
+
+#include <random>
+#include <cstdint>
+#include "AlgorithmInterface.h"
+
+// Double Expansion Trick to transform the name of a class into a string.
+#define STRINGIZE(x) #x
+#define TO_STRING(x) STRINGIZE(x)
+
+// This is the structure that every specific distribution class must have. In order to avoid repetition in the classes
+// definition, this Macro handles the expansion of the code given only the name of the SUBCLASS (which is the name of the
+// algorithm), and the BODY, (which is the specific implementation of the binseg method). The TO_STRING Macro is used
+// in order to register the algorithm in the factory using the class name. Also, in the construtor, the boolean
+// is_registered from Registration class is called in order to instantiate the template.
+#define ALGORITHM(SUBCLASS, BODY)                                                                           \
+    class SUBCLASS: public Algorithm, public Registration<SUBCLASS, Algorithm, AlgorithmFactory> {          \
+    public:                                                                                                 \
+        static std::string factoryName;                                                                     \
+        static std::vector<std::string> param_names;                                                        \
+        SUBCLASS(){                                                                                         \
+            (void) created;                                                                                 \
+        }                                                                                                   \
+        BODY                                                                                                \
+    };
+
+
+ALGORITHM(BS,
+    /**
+     * For regular Binary Segmentation, first the whole segment is created and pushed into the candidates queue.
+     * Before pushing any Segment, its optimal partition is computed and stored as Segment::mid, along with the decrease
+     * in cost that this optimal changepoint produces. Given that the queue is a heap ordered by the best_decrease, it is
+     * guaranteed that its top will always be the optimal partition. To find more segments, just find the best split,
+     * store the info, and add to the candidates queue the two newly created segments, which are evaluated concurrently
+     * if a thread pool is available. The search is greedy, so a resumed run continues from the last model found, with
+     * the candidates queue as it was left. The split segment of every model is recorded, so that the run can also be
+     * extended to new observations (see extend).
+     */
+
+    static std::string description;
+
+    std::vector<int> splitSegments; // The index in the candidates pool of the segment split by each model
+    std::vector<int> runnersUp; // The top of the candidates queue right after each split, or -1 if it was empty
+
+     void binseg(){
+         if (this -> models.getNumRows() == 0){
+             this -> splitSegments.clear();
+             this -> runnersUp.clear();
+             int whole = this -> candidates.add(0, this -> length - 1, this -> dist.get(), this -> minSegLen, 0, 0);
+             this -> evaluate(&this -> candidates[whole], 1);
+             this -> candidates.push(whole);
+             this -> writeFirstModel();
+         }
+         for(int i = this -> models.getNumRows(); i <= this -> numCpts; i++){
+             if (this -> interrupt(i - 1)) return;
+             Segment optCpt = this -> candidates[this -> candidates.top()];
+             if (optCpt.mid == 0 || this -> stops(optCpt.bestDecrease)) return;
+             this -> splitSegments.push_back(this -> candidates.top());
+             this -> candidates.pop();
+             this -> runnersUp.push_back(this -> candidates.empty() ? -1 : this -> candidates.top());
+             this -> writeModel(i, optCpt.start, optCpt.mid, optCpt.end, optCpt.invalidatesIndex, optCpt.invalidatesAfter,
+                                optCpt.bestDecrease);
+             int left = this -> candidates.add(optCpt.start, optCpt.mid, this -> dist.get(), this -> minSegLen, 0, i);
+             int right = this -> candidates.add(optCpt.mid + 1, optCpt.end, this -> dist.get(), this -> minSegLen, 1, i);
+             this -> evaluate(&this -> candidates[left], 2);
+             this -> candidates.push(left);
+             this -> candidates.push(right);
+         }
+     }
+
+     bool isResumable(){
+         return true;
+     }
+
+    /**
+     * Only the segments that end at the previous last observation change when new observations are appended, as long
+     * as the cost of a segment depends only on its own data. They are scanned again from the whole data down, and the
+     * previous models are kept while they split them at the same changepoint, and in the same order with respect to
+     * the other segments, which is checked against the decrease of the segment that was the top of the queue after each
+     * split. The candidates queue is restored to its state at the first model that changes, which is removed along with
+     * the following ones, and the search continues from there. The costs of the kept models are updated, since the cost
+     * of the whole data changes, but their parameters are only estimated again for the segments that grew.
+     */
+    bool extend(int length){
+        int numRows = this -> models.getNumRows();
+        if (this -> interrupted || numRows == 0 || !this -> dist -> hasLocalCost()) return false;
+        this -> length = length;
+        int trailing = 0; // The segment in the candidates pool that ends at the last observation
+        this -> grow(trailing);
+        int kept = 1;
+        for (; kept < numRows; kept++){
+            int split = this -> splitSegments[kept - 1];
+            if (split != trailing){
+                if (this -> candidates.before(trailing, split)) break;
+                continue;
+            }
+            const Segment &segment = this -> candidates[split];
+            int runnerUp = this -> runnersUp[kept - 1];
+            if (segment.mid != this -> models.getSplits()[3 * kept + 1] || this -> stops(segment.bestDecrease) ||
+                (runnerUp >= 0 && this -> candidates.before(runnerUp, split))) break;
+            trailing = 2 * kept; // The right part of the split, which is added after the left one
+            this -> grow(trailing);
+        }
+
+        if (kept < numRows){
+            this -> models.truncate(kept);
+            this -> splitSegments.resize(kept - 1);
+            this -> runnersUp.resize(kept - 1);
+            // The segments of the first kept - 1 splits, which are candidates unless they were split.
+            int numSegments = 2 * kept - 1;
+            std::vector<bool> isSplit(numSegments, false);
+            for (int index: this -> splitSegments) isSplit[index] = true;
+            this -> candidates.truncate(numSegments);
+            for (int index = 0; index < numSegments; index++)
+                if (!isSplit[index]) this -> candidates.push(index);
+        } else this -> candidates.update(trailing);
+
+        // The costs of every kept model, and the parameters of the ones whose segments grew.
+        int numCols = this -> models.getNumCols();
+        double constant = this -> dist -> getConstant();
+        this -> lastCost = this -> dist -> modelCost(0, length - 1);
+        for (int i = 0; i < kept; i++){
+            double * row = this -> models.row(i);
+            const int * splits = this -> models.getSplits() + 3 * i;
+            if (i > 0) this -> lastCost -= this -> candidates[this -> splitSegments[i - 1]].bestDecrease;
+            row[4] = 2 * (this -> lastCost + constant);
+            if (i == 0){
+                row[1] = length;
+                this -> models.setSplit(0, 0, length - 1, 0);
+            } else if (this -> candidates[this -> splitSegments[i - 1]].end != splits[2]){
+                this -> models.setSplit(i, splits[0], splits[1], length - 1);
+            } else continue;
+            this -> dist -> calcModelParams(row, 1, numCols, splits);
+        }
+        this -> completedRows = kept;
+        this -> run();
+        return true;
+    }
+
+    /**
+     * Extends a segment of the candidates pool to the last observation, and computes its optimal partition again.
+     * @param index The index of the segment in the pool.
+     */
+    void grow(int index){
+        Segment &segment = this -> candidates[index];
+        segment = Segment(segment.start, this -> length - 1, this -> dist.get(), this -> minSegLen,
+                          segment.invalidatesAfter, segment.invalidatesIndex);
+        this -> evaluate(&segment, 1);
+    }
+
+     std::vector<std::string> getParamNames(){
+         std::vector<std::string> names = BS::param_names;
+         std::vector<std::string> param_names = this -> dist -> getParamNames();
+         names.insert(names.end(), param_names.begin(), param_names.end());
+         return names;
+     }
+)
+
+
+ALGORITHM(SeedBS,
+    /**
+     * Seeded Binary Segmentation (Kovacs, Li, Buhlmann and Munk, 2020). Instead of scanning the whole segment at each
+     * step, the best split is computed once for a deterministic set of seeded intervals, which cover the data at
+     * several scales. The k-th layer has 2 * ceil(decay^(k-1)) - 1 evenly shifted intervals of length n / decay^(k-1),
+     * down to the shortest length that can still be split. The total length of the intervals is O(n log n), and their
+     * scans are independent, so they are evaluated in parallel. Then, the changepoints are selected greedily from the
+     * intervals with the largest decrease in cost (see Algorithm::selectFromIntervals).
+     */
+
+    static std::string description;
+
+    static constexpr double decay = 1.4142135623730951; // sqrt(2)
+
+    void binseg(){
+        this -> selectFromIntervals(this -> seededIntervals());
+    }
+
+    std::vector<Interval> seededIntervals(){
+        std::vector<Interval> intervals;
+        int minLength = 2 * this -> minSegLen + 1; // The shortest interval with at least one candidate split
+        for (double scale = 1; this -> length / scale >= minLength; scale *= decay){
+            double intervalLength = this -> length / scale;
+            int numIntervals = 2 * (int) ceil(scale) - 1;
+            double shift = numIntervals > 1 ? (this -> length - intervalLength) / (numIntervals - 1) : 0;
+            for (int k = 0; k < numIntervals; k++){
+                int start = floor(k * shift);
+                int end = std::min((int) ceil(k * shift + intervalLength), this -> length) - 1;
+                if (end - start + 1 >= minLength) intervals.emplace_back(start, end);
+            }
+        }
+        std::sort(intervals.begin(), intervals.end());
+        intervals.erase(std::unique(intervals.begin(), intervals.end()), intervals.end());
+        return intervals;
+    }
+
+    std::vector<std::string> getParamNames(){
+        std::vector<std::string> names = SeedBS::param_names;
+        std::vector<std::string> param_names = this -> dist -> getParamNames();
+        names.insert(names.end(), param_names.begin(), param_names.end());
+        return names;
+    }
+)
+
+
+ALGORITHM(WildBS,
+    /**
+     * Wild Binary Segmentation (Fryzlewicz, 2014). The best split of the whole data and of numIntervals random
+     * intervals is computed only once, in parallel if a thread pool is available. Then, the changepoints are selected
+     * greedily from the intervals with the largest decrease in cost that are contained in a segment of the current
+     * model. Every new segment is also added as a candidate, so the cached results of the random intervals are reused
+     * at every step, and only the two new segments are scanned.
+     */
+
+    static std::string description;
+
+    void binseg(){
+        this -> selectFromIntervals(this -> randomIntervals(), true);
+    }
+
+    /**
+     * Draws the random intervals. The start is uniform over the positions that leave room for a split, and the end is
+     * uniform over the positions after start + 2 * minSegLen. The random numbers are taken directly from the 32 bits
+     * Mersenne Twister, so that the intervals of a seed are the same in every platform.
+     */
+    std::vector<Interval> randomIntervals(){
+        std::vector<Interval> intervals;
+        int minLength = 2 * this -> minSegLen + 1; // The shortest interval with at least one candidate split
+        if (this -> length < minLength) return intervals;
+        intervals.emplace_back(0, this -> length - 1);
+        std::mt19937 rng((uint32_t) this -> seed);
+        for (int k = 0; k < this -> numIntervals; k++){
+            int start = uniform(rng, this -> length - minLength + 1);
+            int end = start + minLength - 1 + uniform(rng, this -> length - start - minLength + 1);
+            intervals.emplace_back(start, end);
+        }
+        std::sort(intervals.begin(), intervals.end());
+        intervals.erase(std::unique(intervals.begin(), intervals.end()), intervals.end());
+        return intervals;
+    }
+
+    /**
+     * @return A uniform integer between 0 and range - 1, without the modulo bias.
+     */
+    static int uniform(std::mt19937 &rng, uint32_t range){
+        uint32_t limit = UINT32_MAX - UINT32_MAX % range;
+        uint32_t draw;
+        do draw = rng(); while (draw >= limit);
+        return draw % range;
+    }
+
+    std::vector<std::string> getParamNames(){
+        std::vector<std::string> names = WildBS::param_names;
+        std::vector<std::string> param_names = this -> dist -> getParamNames();
+        names.insert(names.end(), param_names.begin(), param_names.end());
+        return names;
+    }
+)
+
+#endif // BINSEG_ALGORITHMS_H
@@ -0,0 +1,108 @@
+#ifndef BINSEG_BLOCK_HULLS_H
+#define BINSEG_BLOCK_HULLS_H
+
+#include <vector>
+#include <math.h>
+
+/**
+ * Convex hulls of the prefix sums over blocks of consecutive observations, which allow to bound the split costs of a
+ * whole block without evaluating them (see CostKernel). For every complete block, the lower and upper hulls of the
+ * points (i, P_i) are stored, so that the minimum and maximum of P_i - slope * i over the block are obtained by visiting
+ * only their vertices, for any slope. The hulls of noisy data only have a few vertices per block.
+ */
+class BlockHulls {
+
+private:
+
+    std::vector<int> lower; // The indices of the vertices of the lower hull of every block
+    std::vector<int> upper; // The indices of the vertices of the upper hull of every block
+    std::vector<int> lowerStart; // The position of the first vertex of every block in lower, plus the total at the end
+    std::vector<int> upperStart;
+
+    // Andrew's monotone chain of the lower and upper hulls of a block, which is already sorted by index. The cross
+    // product of (a - o) and (b - o) is positive if o, a, b turn counterclockwise.
+    void addBlock(const double * prefix, int first){
+        int lowerCount = 0, upperCount = 0;
+        int lowerVertices[blockSize], upperVertices[blockSize];
+        for (int i = 0; i < blockSize; i++){
+            double value = prefix[first + i];
+            while (lowerCount >= 2){
+                int o = lowerVertices[lowerCount - 2], a = lowerVertices[lowerCount - 1];
+                double cross = (a - o) * (value - prefix[first + o]) - (prefix[first + a] - prefix[first + o]) * (i - o);
+                if (cross > 0) break;
+                lowerCount--;
+            }
+            lowerVertices[lowerCount++] = i;
+            while (upperCount >= 2){
+                int o = upperVertices[upperCount - 2], a = upperVertices[upperCount - 1];
+                double cross = (a - o) * (value - prefix[first + o]) - (prefix[first + a] - prefix[first + o]) * (i - o);
+                if (cross < 0) break;
+                upperCount--;
+            }
+            upperVertices[upperCount++] = i;
+        }
+        for (int v = 0; v < lowerCount; v++) this -> lower.push_back(first + lowerVertices[v]);
+        for (int v = 0; v < upperCount; v++) this -> upper.push_back(first + upperVertices[v]);
+        this -> lowerStart.push_back(this -> lower.size());
+        this -> upperStart.push_back(this -> upper.size());
+    }
+
+public:
+
+    static const int blockSize = 64;
+
+    BlockHulls(){
+        this -> clear();
+    }
+
+    void clear(){
+        this -> lower.clear();
+        this -> upper.clear();
+        this -> lowerStart.assign(1, 0);
+        this -> upperStart.assign(1, 0);
+    }
+
+    int getNumBlocks() const {
+        return this -> lowerStart.size() - 1;
+    }
+
+    size_t getBytes() const {
+        return (this -> lower.capacity() + this -> upper.capacity() + this -> lowerStart.capacity() +
+                this -> upperStart.capacity()) * sizeof(int);
+    }
+
+    /**
+     * Builds the hulls of the blocks that were completed since the last call.
+     * @param prefix The prefix sums.
+     * @param length The number of prefix sums.
+     */
+    void extend(const double * prefix, int length){
+        for (int block = this -> getNumBlocks(); (block + 1) * blockSize <= length; block++){
+            this -> addBlock(prefix, block * blockSize);
+        }
+    }
+
+    /**
+     * Computes the range of P_i - slope * i over a block. It is widened by a relative margin that covers the rounding
+     * of the hulls and of the subtraction.
+     * @param prefix The prefix sums.
+     * @param block The index of the block.
+     * @param slope The slope
+     * @param min Output parameter with the minimum.
+     * @param max Output parameter with the maximum.
+     */
+    void range(const double * prefix, int block, double slope, double &min, double &max) const {
+        min = INFINITY;
+        max = -INFINITY;
+        for (int v = this -> lowerStart[block]; v < this -> lowerStart[block + 1]; v++)
+            min = fmin(min, prefix[this -> lower[v]] - slope * this -> lower[v]);
+        for (int v = this -> upperStart[block]; v < this -> upperStart[block + 1]; v++)
+            max = fmax(max, prefix[this -> upper[v]] - slope * this -> upper[v]);
+        int last = (block + 1) * blockSize - 1;
+        double margin = 1e-12 * (fabs(min) + fabs(max) + 2 * fabs(slope * last));
+        min -= margin;
+        max += margin;
+    }
+};
+
+#endif // BINSEG_BLOCK_HULLS_H
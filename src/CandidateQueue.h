@@ -0,0 +1,164 @@
+#ifndef BINSEG_CANDIDATE_QUEUE_H
+#define BINSEG_CANDIDATE_QUEUE_H
+
+#include <cmath>
+#include <algorithm>
+#include "Segment.h"
+#include "RunCounters.h"
+
+/**
+ * The queue of candidate segments of the Binary Segmentation algorithms. Every Segment is stored in a contiguous pool
+ * (an arena that is only cleared when the algorithm starts over), and a binary max-heap of indexes into the pool is kept
+ * ordered by the bestDecrease. Ties are resolved in favour of the segment that was added first, which reproduces the
+ * order of the std::multiset that was used before. Segments with a NaN decrease are ranked after every other one.
+ */
+class CandidateQueue {
+
+private:
+
+    std::vector<Segment> pool;
+    std::vector<int> heap;
+
+public:
+
+    RunCounters * counters = nullptr; // Optional, counts the operations of the queue
+
+    CandidateQueue() = default;
+
+    /**
+     * Reserves memory for the given number of segments, so that no reallocation happens while adding them.
+     * @param numSegments The expected number of segments.
+     */
+    void reserve(int numSegments){
+        this -> pool.reserve(numSegments);
+        this -> heap.reserve(numSegments);
+    }
+
+    void clear(){
+        this -> pool.clear();
+        this -> heap.clear();
+    }
+
+    /**
+     * Creates a new segment at the end of the pool, but does not push it into the heap. The Segment must be evaluated
+     * with Segment::optimalPartition before it is pushed. Note that references to the pool are invalidated if it grows.
+     * @return The index of the segment in the pool.
+     */
+    int add(int start, int end, Distribution * dist, int minSegLen, int invalidatesAfter, int invalidatesIndex){
+        this -> pool.emplace_back(start, end, dist, minSegLen, invalidatesAfter, invalidatesIndex);
+        return this -> pool.size() - 1;
+    }
+
+    Segment & operator [] (int index){
+        return this -> pool[index];
+    }
+
+    /**
+     * Pushes an evaluated segment into the heap.
+     * @param index The index of the segment in the pool.
+     */
+    void push(int index){
+        this -> heap.push_back(index);
+        if (this -> counters != nullptr){
+            this -> counters -> queueOperations++;
+            this -> counters -> peakCandidates = std::max(this -> counters -> peakCandidates,
+                                                          (long long) this -> heap.size());
+        }
+        this -> siftUp(this -> heap.size() - 1);
+    }
+
+    /**
+     * @return The index of the segment with the largest bestDecrease.
+     */
+    int top(){
+        return this -> heap.front();
+    }
+
+    /**
+     * Removes the top segment from the heap. It remains in the pool, so its index is still valid.
+     */
+    void pop(){
+        if (this -> counters != nullptr) this -> counters -> queueOperations++;
+        this -> heap.front() = this -> heap.back();
+        this -> heap.pop_back();
+        this -> siftDown(0);
+    }
+
+    /**
+     * Restores the order of the heap after the decrease of one of its segments changes. It takes linear time, since the
+     * position of the segment in the heap is not tracked.
+     * @param index The index of the segment in the pool.
+     */
+    void update(int index){
+        int position = std::find(this -> heap.begin(), this -> heap.end(), index) - this -> heap.begin();
+        if (position == (int) this -> heap.size()) return;
+        this -> siftUp(position);
+        this -> siftDown(position);
+    }
+
+    bool empty(){
+        return this -> heap.empty();
+    }
+
+    int size(){
+        return this -> heap.size();
+    }
+
+    /**
+     * @return The number of segments in the pool, including the ones that were popped.
+     */
+    int getNumSegments(){
+        return this -> pool.size();
+    }
+
+    size_t getBytes(){
+        return this -> pool.capacity() * sizeof(Segment) + this -> heap.capacity() * sizeof(int);
+    }
+
+    /**
+     * Removes the segments added after the first numSegments ones, and empties the heap. The remaining segments must be
+     * pushed again if they are still candidates.
+     * @param numSegments The number of segments that are kept in the pool.
+     */
+    void truncate(int numSegments){
+        this -> pool.erase(this -> pool.begin() + numSegments, this -> pool.end());
+        this -> heap.clear();
+    }
+
+    /**
+     * @return Whether the segment a is ranked before the segment b in the heap.
+     */
+    bool before(int a, int b){
+        double decreaseA = this -> pool[a].bestDecrease, decreaseB = this -> pool[b].bestDecrease;
+        bool nanA = std::isnan(decreaseA), nanB = std::isnan(decreaseB);
+        if (nanA != nanB) return nanB;
+        if (!nanA && decreaseA != decreaseB) return decreaseA > decreaseB;
+        return a < b;
+    }
+
+private:
+
+    void siftUp(int child){
+        while (child > 0){
+            int parent = (child - 1) / 2;
+            if (!this -> before(this -> heap[child], this -> heap[parent])) break;
+            std::swap(this -> heap[child], this -> heap[parent]);
+            child = parent;
+        }
+    }
+
+    void siftDown(int parent){
+        int size = this -> heap.size();
+        while (true){
+            int best = parent;
+            int left = 2 * parent + 1, right = left + 1;
+            if (left < size && this -> before(this -> heap[left], this -> heap[best])) best = left;
+            if (right < size && this -> before(this -> heap[right], this -> heap[best])) best = right;
+            if (best == parent) break;
+            std::swap(this -> heap[parent], this -> heap[best]);
+            parent = best;
+        }
+    }
+};
+
+#endif // BINSEG_CANDIDATE_QUEUE_H
@@ -0,0 +1,146 @@
+#ifndef BINSEG_CROSS_VALIDATION_H
+#define BINSEG_CROSS_VALIDATION_H
+
+#include "AlgorithmInterface.h"
+#include "ThreadPool.h"
+
+/**
+ * Selection of the number of changepoints by cross-validation. The data is split into the observations at even and odd
+ * positions (the folds), and the models computed on each fold are evaluated on the other one, pairing the i-th
+ * observations of both folds, which are adjacent in the data. Every fold keeps a single distribution, whose summary
+ * statistics are used both to compute its models and to evaluate the models of the other fold (see
+ * Distribution::heldOutCost). Since every model splits a segment of the previous one, its held out cost is the one of
+ * the previous model plus the change in the held out costs of the split segment, so each model is evaluated in constant
+ * time. The terms of the cost that do not depend on the segmentation (see Distribution::getConstant) are left out, since
+ * they are the same for every model. The folds are computed and evaluated in parallel.
+ */
+class CrossValidation {
+
+private:
+
+    static const int numFolds = 2;
+
+    std::shared_ptr<Distribution> dists[numFolds];
+    std::shared_ptr<Algorithm> algos[numFolds];
+    std::vector<double> costs[numFolds]; // The held out cost of every model of the fold, on the other fold
+    int lengths[numFolds];
+
+    /**
+     * The held out cost, on the other fold, of a segment of the models of a fold. The last observation of the fold with
+     * even positions has no pair if the length of the data is odd.
+     * @param fold The fold of the models.
+     * @param start inclusive
+     * @param end inclusive
+     */
+    double segmentCost(int fold, int start, int end){
+        int other = 1 - fold;
+        int heldOutEnd = std::min(end, this -> lengths[other] - 1);
+        if (start > heldOutEnd) return 0;
+        Cumsum * heldOut = this -> dists[other] -> summaryStatistics.get();
+        return this -> dists[fold] -> heldOutCost(heldOut, start, heldOutEnd, start, end);
+    }
+
+    /**
+     * Computes the held out cost of every model of a fold. The costs of the segments that are infinite (i.e. with a
+     * variance of zero) are counted separately, so that they can be removed when the segment is split.
+     * @param fold The fold of the models.
+     */
+    void validate(int fold){
+        ModelTable &models = this -> algos[fold] -> models;
+        const int * splits = models.getSplits();
+        double finite = 0;
+        int infinite = 0;
+        auto add = [&finite, &infinite](double cost, int sign){
+            if (cost == INFINITY) infinite += sign;
+            else finite += sign * cost;
+        };
+        std::vector<double> &costs = this -> costs[fold];
+        costs.resize(models.getNumRows());
+        add(this -> segmentCost(fold, 0, this -> lengths[fold] - 1), 1);
+        for (int k = 0; k < models.getNumRows(); k++){
+            if (k > 0){
+                int start = splits[3 * k], mid = splits[3 * k + 1], end = splits[3 * k + 2];
+                add(this -> segmentCost(fold, start, end), -1);
+                add(this -> segmentCost(fold, start, mid), 1);
+                add(this -> segmentCost(fold, mid + 1, end), 1);
+            }
+            costs[k] = infinite > 0 ? INFINITY : 2 * finite; // Scaled as the cost of the models
+        }
+    }
+
+public:
+
+    /**
+     * @param algorithm The name of the algorithm, as registered in AlgorithmFactory.
+     * @param distribution The name of the distribution, as registered in DistributionFactory.
+     * @param stableSums Whether to use the stable summary statistics (see Cumsum::setStable).
+     */
+    CrossValidation(std::string algorithm, std::string distribution, bool stableSums){
+        for (int fold = 0; fold < numFolds; fold++){
+            this -> dists[fold] = DistributionFactory::Create(distribution);
+            this -> dists[fold] -> setCumsum();
+            if (stableSums) this -> dists[fold] -> useStableSums();
+            this -> algos[fold] = AlgorithmFactory::Create(algorithm);
+            this -> lengths[fold] = 0;
+        }
+    }
+
+    void setRandomIntervals(int numIntervals, int seed){
+        for (int fold = 0; fold < numFolds; fold++) this -> algos[fold] -> setRandomIntervals(numIntervals, seed);
+    }
+
+    /**
+     * Computes the models of both folds, and evaluates each of them on the other fold.
+     * @param data The vector of data
+     * @param length The length of the data, which must be at least 2.
+     * @param numCpts The maximum number of changepoints.
+     * @param minSegLen The minimum segment length, within each fold.
+     * @param numThreads The number of threads, of which at most one per fold is used.
+     */
+    void run(const double * data, int length, int numCpts, int minSegLen, int numThreads){
+        if (length < numFolds) throw "The data must have at least one observation per fold";
+        ThreadPool pool(std::min(numThreads, numFolds));
+        pool.parallelFor(numFolds, [&](int fold){
+            std::vector<double> values;
+            values.reserve(length / numFolds + 1);
+            for (int i = fold; i < length; i += numFolds) values.push_back(data[i]);
+            this -> lengths[fold] = values.size();
+            this -> algos[fold] -> init(values.data(), values.size(), numCpts, this -> dists[fold], minSegLen);
+            this -> algos[fold] -> run();
+        });
+        pool.parallelFor(numFolds, [this](int fold){
+            this -> validate(fold);
+        });
+    }
+
+    /**
+     * @return The number of models evaluated, which is the smallest number of models found in a fold.
+     */
+    int getNumModels(){
+        return std::min(this -> costs[0].size(), this -> costs[1].size());
+    }
+
+    /**
+     * @param fold 0 for the models of the observations at even positions (the first, third, ... observations), which
+     * are evaluated on the odd ones, and 1 for the models of the observations at odd positions.
+     * @param k The number of changepoints.
+     * @return The held out cost of the model of the fold with k changepoints.
+     */
+    double getHeldOutCost(int fold, int k){
+        return this -> costs[fold][k];
+    }
+
+    /**
+     * @return The number of changepoints with the smallest held out cost in both folds, or the smallest of them if
+     * there are ties.
+     */
+    int getSelected(){
+        int selected = 0;
+        for (int k = 1; k < this -> getNumModels(); k++)
+            if (this -> costs[0][k] + this -> costs[1][k] < this -> costs[0][selected] + this -> costs[1][selected])
+                selected = k;
+        return selected;
+    }
+};
+
+#endif // BINSEG_CROSS_VALIDATION_H
@@ -0,0 +1,677 @@
+//
+// Created by Diego Urgell on 10/06/21.
+//
+
+#ifndef BINSEG_CUMSUM_H
+#define BINSEG_CUMSUM_H
+
+#include <vector>
+#include <algorithm>
+#include <math.h>
+#include "PrefixSums.h"
+#include "BlockHulls.h"
+
+/**
+ * The layouts of the prefix sums that the queries of the summary statistics are compiled for (see StorageView). The
+ * prefix sums are stored for every observation, as doubles (DIRECT_SUMS) or compressed (COMPACT_SUMS), or only at the
+ * end of every run of identical observations (RUN_SUMS).
+ */
+enum SumsLayout {DIRECT_SUMS, COMPACT_SUMS, RUN_SUMS};
+
+/**
+ * Running total used to build the prefix sums. If it is compensated, the rounding error of every addition is
+ * accumulated separately (Neumaier's variant of Kahan summation), so that the error of each prefix sum is of the order
+ * of the machine epsilon times the prefix sum itself, instead of growing with the length of the data.
+ */
+struct RunningSum {
+
+    double total = 0;
+    double compensation = 0;
+    bool compensated = false;
+
+    void add(double value){
+        if (!this -> compensated){
+            this -> total += value;
+            return;
+        }
+        double next = this -> total + value;
+        if (fabs(this -> total) >= fabs(value)) this -> compensation += (this -> total - next) + value;
+        else this -> compensation += (value - next) + this -> total;
+        this -> total = next;
+    }
+
+    double value() const {
+        return this -> compensated ? this -> total + this -> compensation : this -> total;
+    }
+
+    void clear(){
+        this -> total = 0;
+        this -> compensation = 0;
+    }
+
+    /**
+     * Subtracts a value without rounding the compensation separately, when the prefix sums are rebased.
+     */
+    void subtract(double value){
+        this -> total = this -> value() - value;
+        this -> compensation = 0;
+    }
+};
+
+/**
+ * Compute a single time the linear cumulative sum of the data and store it. This will allow to obtain
+ * the sum of the whole data or just a segment in linear time.
+ */
+class Cumsum {
+
+protected:
+
+    PrefixSums linearCumsum; // Prefix sums of the data minus the shift
+    RunningSum linearTotal;
+    int length = 0;
+    bool centered = false;
+    double shift = 0; // The first observation if the data is centered, and 0 otherwise
+    bool runs = false;
+    std::vector<int> runEnds; // The index of the last observation of every run, if the runs are used
+    std::vector<double> runValues; // The observation repeated in every run
+    bool bounded = false;
+    BlockHulls hulls; // The hulls of the linear prefix sums, if the bounds are used
+
+    /**
+     * Sets the shift from the first observation, if the data is centered.
+     */
+    void setShift(const double *data, const int count){
+        this -> shift = this -> centered && count > 0 ? data[0] : 0;
+    }
+
+    /**
+     * Adds the next observation to the runs, if they are used.
+     * @return Whether a new prefix sum must be stored, that is, if the observation does not extend the last run.
+     */
+    bool startsRun(double observation){
+        if (!this -> runs) return true;
+        if (!this -> runEnds.empty() && observation == this -> runValues.back()){
+            this -> runEnds.back()++;
+            return false;
+        }
+        this -> runEnds.push_back(this -> runEnds.empty() ? 0 : this -> runEnds.back() + 1);
+        this -> runValues.push_back(observation);
+        return true;
+    }
+
+    /**
+     * Reads the prefix sum of the observations up to i (of their powers) when only the sums at the end of every run are
+     * stored, by removing the rest of the run of i from the sum at its end. It takes logarithmic time in the number of
+     * runs.
+     * @param sums The prefix sums at the end of every run.
+     * @param i The index of the last observation of the prefix.
+     * @param power 1 for the linear sums and 2 for the quadratic sums.
+     */
+    double runPrefix(const PrefixSums &sums, int i, int power) const {
+        size_t r = std::lower_bound(this -> runEnds.begin(), this -> runEnds.end(), i) - this -> runEnds.begin();
+        return sums[r] - (this -> runEnds[r] - i) * pow(this -> runValues[r] - this -> shift, power);
+    }
+
+    /**
+     * Builds the hulls of the blocks completed by the last observations, if the bounds are used. They are only built for
+     * prefix sums stored as doubles.
+     */
+    void extendBounds(){
+        if (this -> bounded && this -> layout() == DIRECT_SUMS)
+            this -> hulls.extend(this -> linearCumsum.data(), this -> length);
+    }
+
+    template<SumsLayout L>
+    SUMS_INLINE double linearPrefix(int i) const {
+        return L == RUN_SUMS ? this -> runPrefix(this -> linearCumsum, i, 1) :
+               this -> linearCumsum.template at<L == COMPACT_SUMS>(i);
+    }
+
+    // The linear prefix sum before the first observation, which is only not 0 after some observations are removed.
+    template<SumsLayout L>
+    SUMS_INLINE double linearOrigin() const {
+        return L == DIRECT_SUMS ? this -> linearCumsum.origin() : 0;
+    }
+
+    /**
+     * Checks that the given number of observations can be removed from the start of the data.
+     */
+    void checkPop(int count) const {
+        if (this -> runs || this -> bounded || this -> layout() != DIRECT_SUMS)
+            throw "The observations can only be removed from prefix sums stored as doubles, without runs or bounds";
+        if (count < 0 || count > this -> length) throw "Cannot remove more observations than the length of the data";
+    }
+
+public:
+
+    Cumsum() = default;
+
+    virtual ~Cumsum() = default;
+
+    /**
+     * Enables the stable summary statistics. The prefix sums are accumulated with compensated summation and, if
+     * centered, they are computed on the data minus its first observation. The sums of a segment are then obtained
+     * without the cancellation produced by a large offset in the data, which would otherwise make the variance of a
+     * segment zero or negative. The queries are still constant time. It must be called before init.
+     * @param centered Whether the data can be centered, that is, if the costs only depend on the centered sums (see
+     * Distribution::isShiftInvariant).
+     */
+    virtual void setStable(bool centered){
+        this -> centered = centered;
+        this -> linearTotal.compensated = true;
+    }
+
+    /**
+     * This init method computes the cumulative sum of the data array and stores it in a vector. It is virtual so that
+     * it can be overridden in the CumsumSquared Class.
+     * @param data The user input data
+     * @param length The length of the data array.
+     */
+    virtual void init(const double *data, const int length) {
+        this -> setShift(data, length);
+        this -> length = length;
+        this -> linearTotal.clear();
+        this -> linearCumsum.clear();
+        this -> runEnds.clear();
+        this -> runValues.clear();
+        if (!this -> runs) this -> linearCumsum.reserve(length);
+        for(int i = 0; i < length; i++){
+            this -> linearTotal.add(data[i] - this -> shift);
+            if (this -> startsRun(data[i])) this -> linearCumsum.push_back(this -> linearTotal.value());
+            else this -> linearCumsum.setBack(this -> linearTotal.value());
+        }
+        this -> hulls.clear();
+        this -> extendBounds();
+    }
+
+    /**
+     * Stores the prefix sums only at the end of every run of identical observations, together with the index of the
+     * end and the value of the run. The memory is then proportional to the number of runs, and the sums of a segment
+     * take logarithmic time in the number of runs. It must be called before init.
+     */
+    void useRuns(){
+        this -> runs = true;
+    }
+
+    /**
+     * Builds the convex hulls of the linear prefix sums over blocks of BlockHulls::blockSize observations, which bound
+     * the split costs of a whole block (see CostKernel). They take a few bytes per observation, and they are only built
+     * if the prefix sums are stored as doubles. It must be called before init.
+     */
+    void useBounds(){
+        this -> bounded = true;
+    }
+
+    /**
+     * @return The hulls of the linear prefix sums, which have no blocks if the bounds are not used.
+     */
+    const BlockHulls & getBlockHulls() const {
+        return this -> hulls;
+    }
+
+    /**
+     * @return The index of the last observation of every run, which is empty if the runs are not used.
+     */
+    const std::vector<int> & getRunEnds() const {
+        return this -> runEnds;
+    }
+
+    /**
+     * @return The memory reserved for the summary statistics, in bytes. It is virtual so that every subclass adds the
+     * memory of its own sums.
+     */
+    virtual size_t getBytes() const {
+        return this -> linearCumsum.getBytes() + this -> runEnds.capacity() * sizeof(int) +
+               this -> runValues.capacity() * sizeof(double) + this -> hulls.getBytes();
+    }
+
+    /**
+     * Selects the encoding of the prefix sums, in order to reduce their memory (see PrefixSums for the error bounds).
+     * It must be called before init, and it is virtual so that CumsumSquared also changes the quadratic cumulative sum.
+     * @param type The StorageType
+     */
+    virtual void setStorage(StorageType type){
+        this -> linearCumsum.setType(type);
+    }
+
+    /**
+     * Stores the prefix sums in memory mapped scratch files in the given directory, rather than in memory. It must be
+     * called before init, and it is virtual so that CumsumSquared also moves the quadratic cumulative sum.
+     * @param directory An existing directory with enough space for the prefix sums.
+     */
+    virtual void useScratch(const std::string &directory){
+        this -> linearCumsum.useScratch(directory);
+    }
+
+    /**
+     * Reserves space for the given number of observations, so that they can be appended without reallocation.
+     */
+    virtual void reserve(int length){
+        if (!this -> runs) this -> linearCumsum.reserve(length);
+    }
+
+    /**
+     * Appends new observations to the end of the data, extending the cumulative sum in amortized constant time per
+     * observation. It is virtual so that CumsumSquared also extends the quadratic cumulative sum.
+     * @param data The new observations
+     * @param count The number of new observations
+     */
+    virtual void append(const double *data, const int count) {
+        if (this -> length == 0) this -> setShift(data, count);
+        for(int i = 0; i < count; i++){
+            this -> linearTotal.add(data[i] - this -> shift);
+            if (this -> startsRun(data[i])) this -> linearCumsum.push_back(this -> linearTotal.value());
+            else this -> linearCumsum.setBack(this -> linearTotal.value());
+        }
+        this -> length += count;
+        this -> extendBounds();
+    }
+
+    /**
+     * Removes the given number of observations from the start of the data in constant time, so that the summary
+     * statistics hold a sliding window of a stream, and the indices of the queries start at the first observation kept.
+     * Once as many observations were removed as the data has, the prefix sums are rebased (see rebase), which takes
+     * amortized constant time per observation. The prefix sums must be stored as doubles, without runs or bounds. It is
+     * virtual so that CumsumSquared also removes the quadratic cumulative sum.
+     * @param count The number of observations to remove.
+     */
+    virtual void popFront(int count){
+        this -> checkPop(count);
+        this -> linearCumsum.popFront(count);
+        this -> length -= count;
+        if ((int) this -> linearCumsum.getRemoved() >= this -> length) this -> rebase();
+    }
+
+    /**
+     * Subtracts the prefix sum of the removed observations from the prefix sums of the observations kept, and releases
+     * the memory of the removed ones. Otherwise, the prefix sums of a sliding window would keep growing with the
+     * observations that left it, and the rounding errors of their differences would grow with them. It is virtual so
+     * that CumsumSquared also rebases the quadratic cumulative sum.
+     */
+    virtual void rebase(){
+        this -> linearTotal.subtract(this -> linearCumsum.rebase());
+    }
+
+    /**
+     * This function allows to compute the cumulative sum from an start to end index in constant time, by
+     * retrieving the values from the summaryStatistics vector.
+     * @param start inclusive
+     * @param end inclusive
+     * @return The Linear cumulative sum from start to end.
+     */
+    double getLinearSum(int start, int end) {
+        switch (this -> layout()) {
+            case RUN_SUMS: return this -> linearSum<RUN_SUMS>(start, end);
+            case COMPACT_SUMS: return this -> linearSum<COMPACT_SUMS>(start, end);
+            default: return this -> linearSum<DIRECT_SUMS>(start, end);
+        }
+    }
+
+    /**
+     * Same as getLinearSum, but of the data minus the shift. It is the linear sum itself if the data is not centered.
+     * @param start inclusive
+     * @param end inclusive
+     * @return The linear cumulative sum of the centered data from start to end.
+     */
+    double getCenteredLinearSum(int start, int end) {
+        switch (this -> layout()) {
+            case RUN_SUMS: return this -> centeredLinearSum<RUN_SUMS>(start, end);
+            case COMPACT_SUMS: return this -> centeredLinearSum<COMPACT_SUMS>(start, end);
+            default: return this -> centeredLinearSum<DIRECT_SUMS>(start, end);
+        }
+    }
+
+    /**
+     * As this is Linear Cumsum, the method to get a quadratic summaryStatistics should not be called, so it throws an exception.
+     * However, it is virtual so it can be overridden in the CumusmSquared Class.
+     * @param start inclusive
+     * @param end inclusive
+     * @return Runtime error if called.
+     */
+    // nocov start
+    virtual double getQuadraticSum(int start, int end){
+        (void) start; (void) end;
+        throw "No quadratic sum in LinearCumsum";
+    }
+
+    virtual double getCenteredQuadraticSum(int start, int end){
+        (void) start; (void) end;
+        throw "No quadratic sum in LinearCumsum";
+    }
+    // nocov end
+
+    /**
+     * Raw access to the linear cumulative sum, so that vectorized kernels can read it directly. Note that it holds the
+     * sums of the centered data, and that the prefix sum before the first observation is at index -1.
+     * @return A pointer to the first element of the linear cumulative sum, or nullptr if it is not stored as doubles.
+     */
+    const double * getLinearCumsum() const {
+        return this -> runs ? nullptr : this -> linearCumsum.data();
+    }
+
+    double getTotalMean(){
+        switch (this -> layout()) {
+            case RUN_SUMS: return this -> totalMean<RUN_SUMS>();
+            case COMPACT_SUMS: return this -> totalMean<COMPACT_SUMS>();
+            default: return this -> totalMean<DIRECT_SUMS>();
+        }
+    }
+
+    double getMean(int start, int end){
+        return this -> getLinearSum(start, end) / (end - start + 1);
+    }
+
+    // nocov start
+    virtual double getVarianceN(int start, int end, bool fixedMean){
+        (void) start; (void) end; (void) fixedMean;
+        throw "No variance with linear summaryStatistics";
+    }
+
+    virtual double getSquaredDeviations(int start, int end, double center){
+        (void) start; (void) end; (void) center;
+        throw "No variance with linear summaryStatistics";
+    }
+    // nocov end
+
+    /**
+     * @return The layout of the prefix sums, which selects the implementation of the queries.
+     */
+    SumsLayout layout() const {
+        if (this -> runs) return RUN_SUMS;
+        return this -> linearCumsum.isCompact() ? COMPACT_SUMS : DIRECT_SUMS;
+    }
+
+    // The following methods implement the queries above for a layout known at compile time. They are used through
+    // StorageView by the split scans, so that the layout is not checked for every candidate.
+
+    template<SumsLayout L>
+    SUMS_INLINE double centeredLinearSum(int start, int end) {
+        if (start < 0) throw "Index Error";
+        if (start > end) return INFINITY;
+        if (start == 0) return this -> linearPrefix<L>(end) - this -> linearOrigin<L>();
+        return this -> linearPrefix<L>(end) - this -> linearPrefix<L>(start - 1);
+    }
+
+    template<SumsLayout L>
+    SUMS_INLINE double linearSum(int start, int end) {
+        if (start > end) return INFINITY;
+        return this -> centeredLinearSum<L>(start, end) + (end - start + 1) * this -> shift;
+    }
+
+    template<SumsLayout L>
+    SUMS_INLINE double totalMean(){
+        double total = this -> linearPrefix<L>(this -> length - 1) - this -> linearOrigin<L>();
+        return total / this -> length + this -> shift;
+    }
+
+    // nocov start
+    template<SumsLayout L>
+    double centeredQuadraticSum(int start, int end){
+        (void) start; (void) end;
+        throw "No quadratic sum in LinearCumsum";
+    }
+
+    template<SumsLayout L>
+    double quadraticSum(int start, int end){
+        (void) start; (void) end;
+        throw "No quadratic sum in LinearCumsum";
+    }
+
+    template<SumsLayout L>
+    double varianceN(int start, int end, bool fixedMean){
+        (void) start; (void) end; (void) fixedMean;
+        throw "No variance with linear summaryStatistics";
+    }
+    // nocov end
+};
+
+
+/**
+ * Compute a single time the squared and linear cumulative sum of the data and store it, since it inherits from
+ * Cumsum. This will allow to obtain the sum of the whole data or just a segment in linear time. In the algorithm
+ * class, a CumsumLinear pointer will be stored so that polymorphism can be used to store CumsumSquared if necessary.
+ */
+class CumsumSquared: public Cumsum {
+
+private:
+
+    PrefixSums quadraticCumsum; // Prefix sums of the squares of the data minus the shift
+    RunningSum quadraticTotal;
+
+    // Adds the next observation to both prefix sums.
+    void add(double observation){
+        double value = observation - this -> shift;
+        this -> linearTotal.add(value);
+        this -> quadraticTotal.add(pow(value, 2));
+        if (this -> startsRun(observation)){
+            this -> linearCumsum.push_back(this -> linearTotal.value());
+            this -> quadraticCumsum.push_back(this -> quadraticTotal.value());
+        } else {
+            this -> linearCumsum.setBack(this -> linearTotal.value());
+            this -> quadraticCumsum.setBack(this -> quadraticTotal.value());
+        }
+    }
+
+    template<SumsLayout L>
+    SUMS_INLINE double quadraticPrefix(int i) const {
+        return L == RUN_SUMS ? this -> runPrefix(this -> quadraticCumsum, i, 2) :
+               this -> quadraticCumsum.template at<L == COMPACT_SUMS>(i);
+    }
+
+    template<SumsLayout L>
+    SUMS_INLINE double quadraticOrigin() const {
+        return L == DIRECT_SUMS ? this -> quadraticCumsum.origin() : 0;
+    }
+
+public:
+
+    CumsumSquared() = default;
+
+    ~CumsumSquared() = default;
+
+    /**
+     * This method overrides the init method in the base Cumusm class. It initializes the quadraticSum vector along with
+     * LinearSum in order to compute and store both vectors at the same time.
+     * @param data The user's input data
+     * @param length The length of the data vector.
+     */
+    void init(const double *data, const int length) {
+        this -> setShift(data, length);
+        this -> linearTotal.clear();
+        this -> quadraticTotal.clear();
+        this -> linearCumsum.clear();
+        this -> quadraticCumsum.clear();
+        this -> runEnds.clear();
+        this -> runValues.clear();
+        this -> reserve(length);
+        this -> length = length;
+        for(int i = 0; i < length; i++){
+            this -> add(data[i]);
+        }
+        this -> hulls.clear();
+        this -> extendBounds();
+    }
+
+    /**
+     * @return The memory reserved for the linear and quadratic sums, in bytes.
+     */
+    size_t getBytes() const {
+        return Cumsum::getBytes() + this -> quadraticCumsum.getBytes();
+    }
+
+    void setStorage(StorageType type){
+        Cumsum::setStorage(type);
+        this -> quadraticCumsum.setType(type);
+    }
+
+    void setStable(bool centered){
+        Cumsum::setStable(centered);
+        this -> quadraticTotal.compensated = true;
+    }
+
+    void useScratch(const std::string &directory){
+        Cumsum::useScratch(directory);
+        this -> quadraticCumsum.useScratch(directory);
+    }
+
+    void reserve(int length){
+        Cumsum::reserve(length);
+        if (!this -> runs) this -> quadraticCumsum.reserve(length);
+    }
+
+    void append(const double *data, const int count) {
+        if (this -> length == 0) this -> setShift(data, count);
+        for(int i = 0; i < count; i++){
+            this -> add(data[i]);
+        }
+        this -> length += count;
+        this -> extendBounds();
+    }
+
+    void popFront(int count){
+        this -> checkPop(count);
+        this -> quadraticCumsum.popFront(count);
+        Cumsum::popFront(count);
+    }
+
+    void rebase(){
+        Cumsum::rebase();
+        this -> quadraticTotal.subtract(this -> quadraticCumsum.rebase());
+    }
+
+    /**
+     * This method overrides the one from base Cumsum by providing the correct mechanism to compute a quadratic sum
+     * in constant time.
+     * @param start inclusive
+     * @param end inclusive
+     * @return The quadratic cumulative sum from start to end
+     */
+    double getQuadraticSum(int start, int end) final {
+        switch (this -> layout()) {
+            case RUN_SUMS: return this -> quadraticSum<RUN_SUMS>(start, end);
+            case COMPACT_SUMS: return this -> quadraticSum<COMPACT_SUMS>(start, end);
+            default: return this -> quadraticSum<DIRECT_SUMS>(start, end);
+        }
+    }
+
+    /**
+     * Same as getQuadraticSum, but of the data minus the shift.
+     */
+    double getCenteredQuadraticSum(int start, int end) final {
+        switch (this -> layout()) {
+            case RUN_SUMS: return this -> centeredQuadraticSum<RUN_SUMS>(start, end);
+            case COMPACT_SUMS: return this -> centeredQuadraticSum<COMPACT_SUMS>(start, end);
+            default: return this -> centeredQuadraticSum<DIRECT_SUMS>(start, end);
+        }
+    }
+
+    /**
+     * Raw access to the quadratic cumulative sum, so that vectorized kernels can read it directly. The prefix sum
+     * before the first observation is at index -1.
+     * @return A pointer to the first element of the quadratic cumulative sum, or nullptr if it is not stored as doubles.
+     */
+    const double * getQuadraticCumsum() const {
+        return this -> runs ? nullptr : this -> quadraticCumsum.data();
+    }
+
+    /**
+     * Computes the variance of a segment times its length. It is computed on the centered data, since the variance
+     * does not depend on the shift.
+     * @param fixedMean If true, the mean of the whole data is used instead of the mean of the segment.
+     */
+    double getVarianceN(int start, int end, bool fixedMean) final {
+        switch (this -> layout()) {
+            case RUN_SUMS: return this -> varianceN<RUN_SUMS>(start, end, fixedMean);
+            case COMPACT_SUMS: return this -> varianceN<COMPACT_SUMS>(start, end, fixedMean);
+            default: return this -> varianceN<DIRECT_SUMS>(start, end, fixedMean);
+        }
+    }
+
+    /**
+     * Computes the sum of the squared deviations of a segment from a given value, which can be the mean of other data.
+     * It is computed on the centered data, so that it does not suffer from the cancellation of a large offset.
+     * @param center The value from which the deviations are taken, for the original data.
+     */
+    double getSquaredDeviations(int start, int end, double center) final {
+        double lSum = this -> getCenteredLinearSum(start, end);
+        double sSum = this -> getCenteredQuadraticSum(start, end);
+        double offset = center - this -> shift;
+        return sSum - 2 * offset * lSum + (end - start + 1) * pow(offset, 2);
+    }
+
+    template<SumsLayout L>
+    SUMS_INLINE double centeredQuadraticSum(int start, int end) {
+        if (start < 0) throw "Index Error";
+        if (start > end) return INFINITY;
+        if (start == 0) return this -> quadraticPrefix<L>(end) - this -> quadraticOrigin<L>();
+        return this -> quadraticPrefix<L>(end) - this -> quadraticPrefix<L>(start - 1);
+    }
+
+    template<SumsLayout L>
+    SUMS_INLINE double quadraticSum(int start, int end) {
+        if (start > end) return INFINITY;
+        double lSum = this -> centeredLinearSum<L>(start, end);
+        return this -> centeredQuadraticSum<L>(start, end) + 2 * this -> shift * lSum +
+               (end - start + 1) * pow(this -> shift, 2);
+    }
+
+    template<SumsLayout L>
+    SUMS_INLINE double varianceN(int start, int end, bool fixedMean) {
+        double lSum = this -> centeredLinearSum<L>(start, end);
+        double sSum =  this ->  centeredQuadraticSum<L>(start, end);
+        int N = end - start + 1;
+        double mean = fixedMean ? (this -> linearPrefix<L>(this -> length - 1) - this -> linearOrigin<L>()) /
+                                  this -> length : lSum / N; // Of the centered data
+        double varN = (sSum - 2 * mean * lSum + N * pow(mean, 2)); // Variance of segment.
+        return varN;
+    }
+};
+
+
+/**
+ * The summary statistics with a layout known at compile time. The split scans of the distributions (see CostKernel)
+ * read them through this view, so that the layout of the prefix sums is only checked once per scan.
+ * @tparam C Cumsum or CumsumSquared
+ * @tparam L The layout of the prefix sums.
+ */
+template<class C, SumsLayout L>
+class StorageView {
+
+private:
+
+    C * stats;
+
+public:
+
+    explicit StorageView(C * stats): stats(stats) {}
+
+    double getLinearSum(int start, int end){
+        return this -> stats -> template linearSum<L>(start, end);
+    }
+
+    double getCenteredLinearSum(int start, int end){
+        return this -> stats -> template centeredLinearSum<L>(start, end);
+    }
+
+    double getQuadraticSum(int start, int end){
+        return this -> stats -> template quadraticSum<L>(start, end);
+    }
+
+    double getCenteredQuadraticSum(int start, int end){
+        return this -> stats -> template centeredQuadraticSum<L>(start, end);
+    }
+
+    double getTotalMean(){
+        return this -> stats -> template totalMean<L>();
+    }
+
+    double getMean(int start, int end){
+        return this -> getLinearSum(start, end) / (end - start + 1);
+    }
+
+    double getVarianceN(int start, int end, bool fixedMean){
+        return this -> stats -> template varianceN<L>(start, end, fixedMean);
+    }
+};
+
+#endif // BINSEG_CUMSUM_H
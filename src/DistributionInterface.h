@@ -0,0 +1,653 @@
+//
+// Created by Diego Urgell on 23/06/21.
+//
+
+#ifndef BINSEG_DISTRIBUTION_INTERFACE_H
+#define BINSEG_DISTRIBUTION_INTERFACE_H
+
+#include <limits>
+#include "GenericFactory.h"
+#include "MultiCumsum.h"
+#include "SplitScan.h"
+#include "SplitBounds.h"
+#include "ThreadPool.h"
+#include "RunCounters.h"
+
+/**
+ * This is an abstract class, that works as an interface for any of the distribution subclasses. Every one of them must
+ * implement the costFunction method, which is pure virtual. Furthermore, the setCumsum method can be overridden in case
+ * a particular distribution only requires the Linear Cumsum class.
+ */
+class Distribution{
+
+protected:
+
+    long double constant = 0; // The terms of the cost that do not depend on the segmentation, for all the data
+
+public:
+
+    std::shared_ptr<Cumsum> summaryStatistics; // Pointer to Cumsum object, which may also be CumsumSquared
+    std::shared_ptr<ThreadPool> pool; // Optional pool to scan long segments in parallel
+    int parallelThreshold = 0; // Minimum number of candidate splits before the scan is split into chunks
+    std::shared_ptr<RunCounters> counters; // Optional performance counters of the run
+    int searchStride = 1; // The stride of the approximate search (see approximateSplit), which is exact if it is 1
+    int searchWindow = 0; // The candidates around the best one of the stride that are scanned by the approximate search
+
+    Distribution() = default;
+
+    virtual ~Distribution() = default;
+
+    /**
+     * This method creates the setCumsum, and it should be called in order to initialize the Distribution object. Note
+     * that this does not initialize the summaryStatistics, since the data is not yet provided.
+     */
+    virtual void setCumsum(){
+        summaryStatistics = std::make_shared<CumsumSquared>();
+    }
+
+    /**
+     * This is the specific implementation of the cost function, and it completely depends on each of the distributions.
+     * It is key method of this interface and should be implemented by any subclass. It calculates the cost of a segment
+     * given start and end indexes. Note that the summaryStatistics object must have been initialized first (see Algorithm::init())
+     * For the implementation, you must provide the negative log-likelihood of the specific distribution,
+     * @param start inclusive
+     * @param end inclusive
+     * @return The cost of the segment fom start to end.
+     */
+    virtual double costFunction(int start, int end) = 0;
+
+    /**
+     * The cost of a segment that is stored in the models table. It only differs from costFunction when the costs are
+     * computed on the centered data but their value depends on the shift, as for the change in mean.
+     * @param start inclusive
+     * @param end inclusive
+     * @return The cost of the segment from start to end, for the original data.
+     */
+    virtual double modelCost(int start, int end){
+        return this -> costFunction(start, end);
+    }
+
+    /**
+     * This is a wrapper method to get the cost of a particular segmentation. It is useful to get the cost of splitting
+     * a segment in two halves. It calculates first the cost of the left and right partitions, and then adds them up.
+     * @param start inclusive
+     * @param mid index of the partition
+     * @param end inclusive
+     * @return Cost of the partition (rather than only one segment)
+     */
+    double getCost(int start, int mid, int end){
+        double first = this -> costFunction(start, mid);
+        double second = this -> costFunction(mid+1, end);
+        double total = first + second;
+        return total;
+    }
+
+    /**
+     * Scans every candidate split between first and last (inclusive) of the segment [start, end], and returns the
+     * lowest cost of a partition, storing its index in mid. Ties are resolved in favour of the lowest index. If any
+     * candidate has an infinite cost, the scan is abandoned: mid is set to 0 and INFINITY is returned. This generic
+     * version relies on the virtual costFunction, and it is overridden by CostKernel to avoid per-candidate dispatch.
+     * @param start inclusive
+     * @param end inclusive
+     * @param first The first candidate split
+     * @param last The last candidate split
+     * @param mid Output parameter with the best split. It is not modified if there are no candidates.
+     * @return The cost of the best partition
+     */
+    virtual double scanSplits(int start, int end, int first, int last, int &mid){
+        this -> countSplits(last - first + 1);
+        double bestSplitCost = std::numeric_limits<double>::max();
+        for(int i = first; i <= last; i++){
+            double currSplitCost = this -> getCost(start, i, end);
+            if (currSplitCost == INFINITY){
+                mid = 0;
+                return INFINITY;
+            }
+            if (currSplitCost < bestSplitCost){
+                bestSplitCost = currSplitCost;
+                mid = i;
+            }
+        }
+        return bestSplitCost;
+    }
+
+    /**
+     * Finds the best split of the segment [start, end] among the candidates from first to last, with the same semantics
+     * as scanSplits. If a thread pool is set and there are more than parallelThreshold candidates, they are divided in
+     * one chunk per thread, which are scanned in parallel. The results of the chunks are reduced in order, so that
+     * ties are still resolved in favour of the lowest index.
+     * @param start inclusive
+     * @param end inclusive
+     * @param first The first candidate split
+     * @param last The last candidate split
+     * @param mid Output parameter with the best split. It is not modified if there are no candidates.
+     * @return The cost of the best partition
+     */
+    double bestSplit(int start, int end, int first, int last, int &mid){
+        return this -> scanChunks(first, last, 1, mid, [this, start, end](int chunkFirst, int chunkLast, int &chunkMid){
+            return this -> scanSplits(start, end, chunkFirst, chunkLast, chunkMid);
+        });
+    }
+
+    /**
+     * Approximate version of bestSplit, for exploratory analyses of very long series. The cost is first evaluated at
+     * every searchStride-th candidate from first, and then the best split is searched exactly (with bestSplit) among the
+     * candidates within searchWindow positions of the best one of the stride. It evaluates about
+     * (last - first) / searchStride + 2 * searchWindow candidates instead of all of them. The result is the exact one
+     * whenever the best candidate of the stride is within searchWindow positions of the best split, as for clear
+     * changes, and otherwise it may only be a local optimum. An infinite cost only abandons the search if it is found
+     * at one of the evaluated candidates. Segments with too few candidates are searched exactly.
+     * @param start inclusive
+     * @param end inclusive
+     * @param first The first candidate split
+     * @param last The last candidate split
+     * @param mid Output parameter with the best split. It is not modified if there are no candidates.
+     * @return The cost of the best partition found.
+     */
+    double approximateSplit(int start, int end, int first, int last, int &mid){
+        int stride = this -> searchStride, window = this -> searchWindow;
+        if (stride <= 1 || (long long) last - first < 2LL * window + stride)
+            return this -> bestSplit(start, end, first, last, mid);
+        int coarseMid = first;
+        double coarseCost = this -> scanChunks(first, last, stride, coarseMid, [this, start, end, stride]
+                (int chunkFirst, int chunkLast, int &chunkMid){
+            return this -> scanStride(start, end, chunkFirst, chunkLast, stride, chunkMid);
+        });
+        if (coarseCost == INFINITY){
+            mid = 0;
+            return INFINITY;
+        }
+        return this -> bestSplit(start, end, std::max(first, coarseMid - window), std::min(last, coarseMid + window),
+                                 mid);
+    }
+
+    /**
+     * Scans the candidates first, first + stride, ... up to last, with the same semantics as scanSplits. It relies on
+     * the virtual costFunction, since the candidates are not contiguous.
+     */
+    double scanStride(int start, int end, int first, int last, int stride, int &mid){
+        double bestSplitCost = std::numeric_limits<double>::max();
+        long long scanned = 0;
+        for (long long i = first; i <= last; i += stride, scanned++){
+            double currSplitCost = this -> getCost(start, i, end);
+            if (currSplitCost == INFINITY){
+                this -> countSplits(scanned + 1);
+                mid = 0;
+                return INFINITY;
+            }
+            if (currSplitCost < bestSplitCost){
+                bestSplitCost = currSplitCost;
+                mid = i;
+            }
+        }
+        this -> countSplits(scanned);
+        return bestSplitCost;
+    }
+
+    /**
+     * Divides the candidates first, first + stride, ... up to last in one chunk per thread of the pool, which are
+     * scanned in parallel by scanChunk if there are more than parallelThreshold candidates, or scans all of them at
+     * once otherwise. The results of the chunks are reduced in order, so that ties are resolved in favour of the lowest
+     * index, and an infinite cost in any chunk abandons the search (see scanSplits).
+     * @param scanChunk The scan of the candidates from a first to a last one of the stride, with the same semantics as
+     * scanSplits.
+     */
+    template<class F>
+    double scanChunks(int first, int last, int stride, int &mid, const F &scanChunk){
+        int candidates = (last - first) / stride + 1;
+        if (this -> pool == nullptr || this -> pool -> size() == 1 || candidates <= this -> parallelThreshold)
+            return scanChunk(first, last, mid);
+
+        int numChunks = this -> pool -> size();
+        std::vector<int> chunkMids(numChunks, -1);
+        std::vector<double> chunkCosts(numChunks);
+        this -> pool -> parallelFor(numChunks, [&](int k){
+            int chunkFirst = first + stride * ((long long) candidates * k / numChunks);
+            int chunkLast = first + stride * ((long long) candidates * (k + 1) / numChunks - 1);
+            chunkCosts[k] = scanChunk(chunkFirst, chunkLast, chunkMids[k]);
+        });
+
+        double bestSplitCost = std::numeric_limits<double>::max();
+        for (int k = 0; k < numChunks; k++){
+            if (chunkCosts[k] == INFINITY){
+                mid = 0;
+                return INFINITY;
+            }
+        }
+        for (int k = 0; k < numChunks; k++){
+            if (chunkMids[k] >= 0 && chunkCosts[k] < bestSplitCost){
+                bestSplitCost = chunkCosts[k];
+                mid = chunkMids[k];
+            }
+        }
+        return bestSplitCost;
+    }
+
+    /**
+     * Counts the cost evaluations of a scan over the given number of candidate splits, if the counters are enabled. It
+     * is called once per scan, so that the counters do not slow down the loop over the candidates.
+     */
+    void countSplits(long long splits){
+        if (this -> counters != nullptr && splits > 0) this -> counters -> costEvaluations += 2 * splits;
+    }
+
+    /**
+     * Whether the cost of a segment depends only on the data inside of it. If it also depends on statistics of the
+     * whole data (i.e. the total mean), the costs of every segment change when new observations are appended.
+     * @return true unless overridden.
+     */
+    virtual bool hasLocalCost(){
+        return true;
+    }
+
+    /**
+     * @return Whether the best splits and the decreases in cost do not change when a constant is added to the data, so
+     * that the stable summary statistics can center it (see Cumsum::setStable).
+     */
+    virtual bool isShiftInvariant(){
+        return false;
+    }
+
+    /**
+     * Sets the number of channels of the data, which is only larger than 1 for the multivariate distributions (see
+     * MultiKernel). It must be called after setCumsum and before the data is added.
+     * @param channels The number of channels
+     */
+    virtual void setChannels(int channels){
+        if (channels != 1) throw "The distribution is univariate, so the data must have a single channel";
+    }
+
+    /**
+     * Enables the stable summary statistics. It must be called after setCumsum and before the data is added.
+     */
+    void useStableSums(){
+        this -> summaryStatistics -> setStable(this -> isShiftInvariant());
+    }
+
+    /**
+     * Initializes the summary statistics with the data, and computes the terms of the cost that do not depend on the
+     * segmentation (see addConstant).
+     * @param data The vector of data
+     * @param length The length of the data
+     */
+    void setData(const double * data, int length){
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        this -> summaryStatistics -> init(data, length);
+        if (this -> counters != nullptr) this -> counters -> addInitTime(begin);
+        this -> constant = 0;
+        this -> addConstant(data, length);
+    }
+
+    /**
+     * Same as setData, but with summary statistics that already hold the data, which may be shared with other
+     * distributions (see SharedStatistics). They are not modified.
+     * @param statistics The summary statistics of the data.
+     * @param data The vector of data
+     * @param length The length of the data
+     */
+    void shareData(std::shared_ptr<Cumsum> statistics, const double * data, int length){
+        this -> summaryStatistics = statistics;
+        this -> constant = 0;
+        this -> addConstant(data, length);
+    }
+
+    /**
+     * Same as setData, but the observations are appended to the ones that were already added.
+     */
+    void appendData(const double * data, int count){
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        this -> summaryStatistics -> append(data, count);
+        if (this -> counters != nullptr) this -> counters -> addInitTime(begin);
+        this -> addConstant(data, count);
+    }
+
+    /**
+     * Removes the oldest observations from the summary statistics in constant time (see Cumsum::popFront), so that they
+     * hold a sliding window of a stream.
+     * @param data The removed observations, whose terms are subtracted from the constant
+     * @param count The number of removed observations
+     */
+    void popData(const double * data, int count){
+        this -> summaryStatistics -> popFront(count);
+        long double kept = this -> constant;
+        this -> constant = 0;
+        this -> addConstant(data, count);
+        this -> constant = kept - this -> constant;
+    }
+
+    /**
+     * @return The terms of the cost of every model that do not depend on the segmentation, for all the data added.
+     */
+    double getConstant(){
+        return (double) this -> constant;
+    }
+
+    /**
+     * Accumulates the terms of the negative log-likelihood that the cost function omits, since they are the same for
+     * every segmentation (i.e. the sum of squares of the data for the change in mean). They are only needed to report
+     * the complete cost of each model. The sum is sequential and in extended precision, as in the sum of R, so that it
+     * does not depend on how the data is divided in appends. It does nothing unless overridden.
+     * @param data The observations
+     * @param count The number of observations
+     */
+    virtual void addConstant(const double * data, int count){
+        (void) data;
+        (void) count;
+    }
+
+    /**
+     * Estimates the parameters of the two segments created by a split, and stores them after the first five columns of
+     * the row of the model (see ModelTable).
+     * @param start inclusive
+     * @param mid The changepoint
+     * @param end inclusive
+     * @param row The row of the model.
+     */
+    virtual void calcParams(int start, int mid, int end, double * row) = 0;
+
+    /**
+     * Estimates the parameters of every model in a single pass, once all the changepoints are known.
+     * @param rows The first row of the models table.
+     * @param numRows The number of models.
+     * @param numCols The number of columns of each row.
+     * @param splits The start, changepoint and end of the split that created each model (see ModelTable).
+     */
+    virtual void calcModelParams(double * rows, int numRows, int numCols, const int * splits){
+        for (int i = 0; i < numRows; i++, splits += 3)
+            this -> calcParams(splits[0], splits[1], splits[2], rows + (size_t) i * numCols);
+    }
+
+    virtual std::vector<std::string> getParamNames() = 0;
+
+    virtual int getParamCount() = 0;
+
+    /**
+     * The cost of a segment of other data (i.e. held out for validation), with the parameters estimated from a segment
+     * of the data of the distribution instead of its own. It is on the same scale as modelCost, to which it is equal
+     * when both segments hold the same observations, so that the cost of a model on held out data is the sum of the
+     * held out costs of its segments plus the terms of the held out data that do not depend on the segmentation.
+     * @param heldOut The summary statistics of the held out data, of the same class as the ones of the distribution.
+     * @param start inclusive, in the held out data.
+     * @param end inclusive, in the held out data.
+     * @param trainStart inclusive, in the data of the distribution.
+     * @param trainEnd inclusive, in the data of the distribution.
+     * @return The cost of the held out segment.
+     */
+    virtual double heldOutCost(Cumsum * heldOut, int start, int end, int trainStart, int trainEnd){
+        (void) heldOut; (void) start; (void) end; (void) trainStart; (void) trainEnd;
+        throw "The held out cost is not available for the distribution";
+    }
+
+};
+
+/**
+ * Statically dispatched implementation of the split scan. Every distribution inherits from this template with itself as
+ * the parameter (CRTP), and provides a template cost method that takes the concrete summary statistics type. Then, the
+ * scan is instantiated once per Cumsum kind and layout of the prefix sums (see StorageView), so that the cost of both
+ * halves is inlined into a single loop without any virtual calls. The summary statistics type is resolved only once per
+ * scan. If the distribution declares a closed-form splitCost, the vectorized SplitScan is used whenever the CPU supports
+ * it. If it declares runSplits, only the first and last splits of every run are scanned when the runs are stored. If the
+ * bounds of the summary statistics are built and the split cost has a lower bound, the blocks of candidates that cannot
+ * improve the best split are skipped.
+ * @tparam D The specific distribution (i.e. mean_norm)
+ */
+template<class D>
+class CostKernel: public Distribution {
+
+public:
+
+    static const SplitCost splitCost = NO_SPLIT_COST;
+
+    // Whether the cost of a split is concave as it moves within a run of identical observations, so that the best split
+    // of the run is at one of its ends. The first and second splits of a run (and the last two) are both scanned, since
+    // the cost can be undefined at the end of a run where one of the halves has a null sum.
+    static const bool runSplits = false;
+
+    double scanSplits(int start, int end, int first, int last, int &mid){
+        const int blockSize = BlockHulls::blockSize;
+        if (SplitBounds::available(D::splitCost) && first >= start && last < end &&
+            this -> summaryStatistics -> getBlockHulls().getNumBlocks() > 0 &&
+            (last + 1) / blockSize - (first + blockSize - 1) / blockSize >= 2)
+            return this -> scanPruned(start, end, first, last, mid);
+        return this -> scanRange(start, end, first, last, mid);
+    }
+
+    void calcModelParams(double * rows, int numRows, int numCols, const int * splits){
+        D * self = static_cast<D *>(this);
+        for (int i = 0; i < numRows; i++, splits += 3)
+            self -> D::calcParams(splits[0], splits[1], splits[2], rows + (size_t) i * numCols);
+    }
+
+private:
+
+    /**
+     * Same as scanSplits, but it skips the blocks of candidates whose lower bound (see SplitBounds) cannot improve the
+     * best split found so far. The blocks are scanned from the lowest bound, so that a good split is found early. A
+     * block is only skipped if its bound exceeds the best cost by more than a relative tolerance, which covers the
+     * rounding of the bounds and of the costs. Then, the result is the same as the one of the full scan.
+     */
+    double scanPruned(int start, int end, int first, int last, int &mid){
+        const int blockSize = BlockHulls::blockSize;
+        const BlockHulls &hulls = this -> summaryStatistics -> getBlockHulls();
+        const double * prefix = this -> summaryStatistics -> getLinearCumsum();
+        int firstBlock = (first + blockSize - 1) / blockSize;
+        int lastBlock = std::min((last + 1) / blockSize, hulls.getNumBlocks()) - 1;
+        double base = start == 0 ? 0 : prefix[start - 1];
+        double total = prefix[end] - base;
+        double length = end - start + 1;
+        double slope = total / length;
+        double offset = base - slope * (start - 1); // The deviation of a candidate i is prefix[i] - slope * i - offset
+
+        std::vector<std::pair<double, int>> bounds;
+        bounds.reserve(lastBlock - firstBlock + 1);
+        for (int block = firstBlock; block <= lastBlock; block++){
+            double dMin, dMax;
+            hulls.range(prefix, block, slope, dMin, dMax);
+            double bound = SplitBounds::lower<D::splitCost>(total, length, block * blockSize - start + 1,
+                                                            (block + 1) * blockSize - start, dMin - offset,
+                                                            dMax - offset);
+            bounds.push_back(std::make_pair(bound, block));
+        }
+        std::sort(bounds.begin(), bounds.end());
+
+        double bestSplitCost = std::numeric_limits<double>::max();
+        int bestMid = -1;
+        // The candidates outside of the complete blocks are always scanned.
+        if (!this -> mergeRange(start, end, first, firstBlock * blockSize - 1, bestSplitCost, bestMid) ||
+            !this -> mergeRange(start, end, (lastBlock + 1) * blockSize, last, bestSplitCost, bestMid)){
+            mid = 0;
+            return INFINITY;
+        }
+        for (size_t k = 0; k < bounds.size(); k++){
+            if (bounds[k].first > bestSplitCost + 1e-10 * (fabs(bestSplitCost) + fabs(bounds[k].first))) break;
+            int block = bounds[k].second;
+            if (!this -> mergeRange(start, end, block * blockSize, (block + 1) * blockSize - 1, bestSplitCost,
+                                    bestMid)){
+                mid = 0;
+                return INFINITY;
+            }
+        }
+        if (bestMid >= 0) mid = bestMid;
+        return bestSplitCost;
+    }
+
+    // Scans the candidates from first to last, and keeps the best split in bestMid, resolving ties in favour of the
+    // lowest index. Returns false if the scan is abandoned because of an infinite cost.
+    bool mergeRange(int start, int end, int first, int last, double &bestSplitCost, int &bestMid){
+        if (first > last) return true;
+        int rangeMid = -1;
+        double rangeCost = this -> scanRange(start, end, first, last, rangeMid);
+        if (rangeCost == INFINITY) return false;
+        if (rangeMid >= 0 && (rangeCost < bestSplitCost || (rangeCost == bestSplitCost && rangeMid < bestMid))){
+            bestSplitCost = rangeCost;
+            bestMid = rangeMid;
+        }
+        return true;
+    }
+
+    // Scans every candidate from first to last, with the vectorized scan if possible, or the scalar scan for the layout.
+    double scanRange(int start, int end, int first, int last, int &mid){
+        Cumsum * stats = this -> summaryStatistics.get();
+        CumsumSquared * squared = dynamic_cast<CumsumSquared *>(stats);
+        if (D::splitCost != NO_SPLIT_COST && first >= start && last < end && stats -> getLinearCumsum() != nullptr &&
+            (squared != nullptr || D::splitCost != MEANVAR_NORM_COST)){
+            double bestSplitCost;
+            const double * quadratic = squared != nullptr ? squared -> getQuadraticCumsum() : nullptr;
+            if (SplitScan::scan<D::splitCost>(stats -> getLinearCumsum(), quadratic, start, end, first, last, mid,
+                                              bestSplitCost)){
+                this -> countSplits(last - first + 1);
+                return bestSplitCost;
+            }
+        }
+        if (squared != nullptr) return this -> scanLayout(squared, start, end, first, last, mid);
+        return this -> scanLayout(stats, start, end, first, last, mid);
+    }
+
+    template<class C>
+    double scanLayout(C * stats, int start, int end, int first, int last, int &mid){
+        switch (stats -> layout()) {
+            case RUN_SUMS:
+                if (D::runSplits)
+                    return this -> scanRuns(StorageView<C, RUN_SUMS>(stats), stats -> getRunEnds(), start, end,
+                                            first, last, mid);
+                return this -> scan(StorageView<C, RUN_SUMS>(stats), start, end, first, last, mid);
+            case COMPACT_SUMS:
+                return this -> scan(StorageView<C, COMPACT_SUMS>(stats), start, end, first, last, mid);
+            default:
+                return this -> scan(StorageView<C, DIRECT_SUMS>(stats), start, end, first, last, mid);
+        }
+    }
+
+    // Same as scan, but only for first, last, and the first two and last two splits of every run in between.
+    template<class S>
+    double scanRuns(S view, const std::vector<int> &runEnds, int start, int end, int first, int last, int &mid){
+        S * stats = &view;
+        D * self = static_cast<D *>(this);
+        double bestSplitCost = std::numeric_limits<double>::max();
+        int previous = first - 1, scanned = 0;
+        size_t r = std::lower_bound(runEnds.begin(), runEnds.end(), first) - runEnds.begin();
+        for (; previous < last; r++){
+            int runStart = r > 0 ? runEnds[r - 1] + 1 : 0;
+            int candidates[4] = {first, runStart, runEnds[r] - 1, runEnds[r]};
+            for (int c = 0; c < 4; c++){
+                int i = std::min(candidates[c], last);
+                if (i <= previous) continue;
+                previous = i;
+                scanned++;
+                double currSplitCost = self -> cost(stats, start, i) + self -> cost(stats, i + 1, end);
+                if (currSplitCost == INFINITY){
+                    this -> countSplits(scanned);
+                    mid = 0;
+                    return INFINITY;
+                }
+                if (currSplitCost < bestSplitCost){
+                    bestSplitCost = currSplitCost;
+                    mid = i;
+                }
+            }
+        }
+        this -> countSplits(scanned);
+        return bestSplitCost;
+    }
+
+    template<class S>
+    double scan(S view, int start, int end, int first, int last, int &mid){
+        this -> countSplits(last - first + 1);
+        S * stats = &view;
+        D * self = static_cast<D *>(this);
+        double bestSplitCost = std::numeric_limits<double>::max();
+        for(int i = first; i <= last; i++){
+            double currSplitCost = self -> cost(stats, start, i) + self -> cost(stats, i + 1, end);
+            if (currSplitCost == INFINITY){
+                mid = 0;
+                return INFINITY;
+            }
+            if (currSplitCost < bestSplitCost){
+                bestSplitCost = currSplitCost;
+                mid = i;
+            }
+        }
+        return bestSplitCost;
+    }
+};
+
+/**
+ * Statically dispatched split scan of the multivariate distributions, as CostKernel for the univariate ones. Every
+ * multivariate distribution inherits from this template with itself as the parameter, and provides a template cost
+ * method that takes the MultiCumsum and sums the cost of a segment across all the channels. The summary statistics are
+ * resolved only once per scan, so there are no virtual calls per candidate. The data is a column-major matrix, with the
+ * number of channels given by setChannels.
+ * @tparam D The specific distribution (i.e. multi_mean_norm)
+ */
+template<class D>
+class MultiKernel: public Distribution {
+
+public:
+
+    void setChannels(int channels){
+        this -> statistics() -> setChannels(channels);
+    }
+
+    bool isShiftInvariant(){
+        return true;
+    }
+
+    double scanSplits(int start, int end, int first, int last, int &mid){
+        this -> countSplits(last - first + 1);
+        MultiCumsum * stats = this -> statistics();
+        D * self = static_cast<D *>(this);
+        double bestSplitCost = std::numeric_limits<double>::max();
+        for(int i = first; i <= last; i++){
+            double currSplitCost = self -> cost(stats, start, i) + self -> cost(stats, i + 1, end);
+            if (currSplitCost == INFINITY){
+                mid = 0;
+                return INFINITY;
+            }
+            if (currSplitCost < bestSplitCost){
+                bestSplitCost = currSplitCost;
+                mid = i;
+            }
+        }
+        return bestSplitCost;
+    }
+
+    void calcModelParams(double * rows, int numRows, int numCols, const int * splits){
+        D * self = static_cast<D *>(this);
+        for (int i = 0; i < numRows; i++, splits += 3)
+            self -> D::calcParams(splits[0], splits[1], splits[2], rows + (size_t) i * numCols);
+    }
+
+protected:
+
+    MultiCumsum * statistics(){
+        return static_cast<MultiCumsum *>(this -> summaryStatistics.get());
+    }
+
+    /**
+     * @return The names of the parameters of every channel, as the given names followed by the index of the channel.
+     * The parameters of all the channels with the same name are contiguous.
+     */
+    std::vector<std::string> channelNames(const std::vector<std::string> &names){
+        std::vector<std::string> channelNames;
+        for (const std::string &name: names)
+            for (int c = 1; c <= this -> statistics() -> getChannels(); c++)
+                channelNames.push_back(name + "_" + std::to_string(c));
+        return channelNames;
+    }
+};
+
+/**
+ * This class implements the GenericFactory interface for the Distribution interface. It exists only to instantiate the
+ * template, and initialize and store the mapping of registered classes.
+ */
+class DistributionFactory: public GenericFactory<Distribution>{
+    void foo(){(void)created;}
+};
+
+// The registered distributions are defined once, in Registry.cpp.
+template<>
+std::map<std::string, std::shared_ptr<Distribution>(*)()> GenericFactory<Distribution>::regSpecs;
+template<>
+std::map<std::string, std::string> GenericFactory<Distribution>::regDescs;
+
+#endif // BINSEG_DISTRIBUTION_INTERFACE_H
@@ -0,0 +1,473 @@
+//
+// Created by Diego Urgell on 10/06/21.
+//
+
+#ifndef BINSEG_DISTRIBUTIONS_H
+#define BINSEG_DISTRIBUTIONS_H
+
+#include "DistributionInterface.h"
+
+// Every distribution class is expanded from this Macro, given the name of the SUBCLASS, the CUMSUM class that holds the
+// summary statistics it requires, and the BODY with the specific implementation. The BODY must provide a template cost
+// method, which is inlined by CostKernel into the split scan for each type of summary statistics, while costFunction
+// exposes the same cost through the virtual Distribution interface.
+#define DISTRIBUTION(SUBCLASS, CUMSUM, BODY)                                                                \
+    class SUBCLASS: public CostKernel<SUBCLASS>, public Registration<SUBCLASS, Distribution, DistributionFactory> { \
+    public:                                                                                                 \
+        static std::string factoryName;                                                                     \
+        static std::vector<std::string> param_names;                                                        \
+        SUBCLASS(){(void) created;}                                                                         \
+        void setCumsum(){                                                                                   \
+            this -> summaryStatistics = std::make_shared<CUMSUM>();                                         \
+        }                                                                                                   \
+        double costFunction(int start, int end){                                                            \
+            return this -> cost(this -> summaryStatistics.get(), start, end);                               \
+        }                                                                                                   \
+        BODY                                                                                                \
+    };
+
+// The multivariate distributions are expanded from this Macro in the same way, given the ChannelSums that their
+// MultiCumsum must store. The BODY must provide a cost method that takes the MultiCumsum (see MultiKernel), and sums
+// the cost of a segment over all the channels.
+#define MULTI_DISTRIBUTION(SUBCLASS, SUMS, BODY)                                                            \
+    class SUBCLASS: public MultiKernel<SUBCLASS>, public Registration<SUBCLASS, Distribution, DistributionFactory> { \
+    public:                                                                                                 \
+        static std::string factoryName;                                                                     \
+        static std::vector<std::string> param_names;                                                        \
+        SUBCLASS(){(void) created;}                                                                         \
+        void setCumsum(){                                                                                   \
+            this -> summaryStatistics = std::make_shared<MultiCumsum>(SUMS);                                \
+        }                                                                                                   \
+        double costFunction(int start, int end){                                                            \
+            return this -> cost(this -> statistics(), start, end);                                          \
+        }                                                                                                   \
+        BODY                                                                                                \
+    };
+
+
+DISTRIBUTION(mean_norm, Cumsum,
+
+    static std::string description;
+
+    static const SplitCost splitCost = MEAN_NORM_COST;
+
+    static const bool runSplits = true;
+
+    template<class S>
+    double cost(S * stats, int start, int end){
+        double lSum = stats -> getCenteredLinearSum(start, end);
+        double N = end - start + 1;
+        return - pow(lSum, 2)/N;
+    }
+
+    bool isShiftInvariant(){
+        return true;
+    }
+
+    double modelCost(int start, int end){
+        double lSum = this -> summaryStatistics -> getLinearSum(start, end);
+        double N = end - start + 1;
+        return - pow(lSum, 2)/N;
+    }
+
+    void addConstant(const double * data, int count){
+        for (int i = 0; i < count; i++) this -> constant += data[i] * data[i];
+    }
+
+    void calcParams(int start, int mid, int end, double * row){
+        row[5] = this -> summaryStatistics -> getMean(start, mid);
+        row[6] = this -> summaryStatistics -> getMean(mid + 1, end);
+    }
+
+    double heldOutCost(Cumsum * heldOut, int start, int end, int trainStart, int trainEnd){
+        double mean = this -> summaryStatistics -> getMean(trainStart, trainEnd);
+        double N = end - start + 1;
+        return - 2 * mean * heldOut -> getLinearSum(start, end) + N * pow(mean, 2);
+    }
+
+    std::vector<std::string> getParamNames(){
+        std::vector<std::string> names =  mean_norm::param_names;
+        return names;
+    }
+
+    int getParamCount(){
+        return 2;
+    }
+)
+
+
+DISTRIBUTION(var_norm, CumsumSquared,
+
+    static std::string description;
+
+    template<class S>
+    double cost(S * stats, int start, int end){
+        double varN = stats -> getVarianceN(start, end, true); // Variance of segment, with fixed mean.
+        int N = end - start + 1;
+        if(varN <= 0) return INFINITY;
+        return N * (log(2*M_PI) + log(varN/N) + 1);
+    }
+
+    bool hasLocalCost(){
+        return false; // Depends on the total mean
+    }
+
+    bool isShiftInvariant(){
+        return true;
+    }
+
+    void calcParams(int start, int mid, int end, double * row){
+        double varLeft = this -> summaryStatistics -> getVarianceN(start, mid, true);
+        double varRight = this -> summaryStatistics -> getVarianceN(mid + 1, end, true);
+        row[5] = varLeft / (mid - start + 1);
+        row[6] = varRight / (end - mid);
+    }
+
+    double heldOutCost(Cumsum * heldOut, int start, int end, int trainStart, int trainEnd){
+        double varN = this -> summaryStatistics -> getVarianceN(trainStart, trainEnd, true);
+        double var = varN / (trainEnd - trainStart + 1);
+        double devN = heldOut -> getSquaredDeviations(start, end, this -> summaryStatistics -> getTotalMean());
+        int N = end - start + 1;
+        if(var <= 0) return INFINITY;
+        return N * (log(2*M_PI) + log(var)) + devN / var;
+    }
+
+    std::vector<std::string> getParamNames(){
+        return var_norm::param_names;
+    }
+
+    int getParamCount(){
+        return 2;
+    }
+
+)
+
+DISTRIBUTION(meanvar_norm, CumsumSquared,
+
+    static std::string description;
+
+    static const SplitCost splitCost = MEANVAR_NORM_COST;
+
+    template<class S>
+    double cost(S * stats, int start, int end){
+        double lSum =  stats -> getCenteredLinearSum(start, end);
+        double sSum =  stats -> getCenteredQuadraticSum(start, end);
+        int N = end - start + 1;
+        double varN = (sSum - (lSum*lSum/N));
+        if(varN <= 0) return INFINITY;
+        return N*(log(varN/N) + log(2*M_PI) + 1);
+    }
+
+    bool isShiftInvariant(){
+        return true;
+    }
+
+    void calcParams(int start, int mid, int end, double * row){
+        double meanLeft = this -> summaryStatistics -> getMean(start, mid);
+        double meanRight = this -> summaryStatistics -> getMean(mid + 1, end);
+        double varLeft = this -> summaryStatistics -> getVarianceN(start, mid, false);
+        double varRight = this -> summaryStatistics -> getVarianceN(mid + 1, end, false);
+
+        row[5] = meanLeft;
+        row[6] = meanRight;
+        row[7] = varLeft / (mid - start + 1);
+        row[8] = varRight / (end - mid);
+    }
+
+    double heldOutCost(Cumsum * heldOut, int start, int end, int trainStart, int trainEnd){
+        double mean = this -> summaryStatistics -> getMean(trainStart, trainEnd);
+        double varN = this -> summaryStatistics -> getVarianceN(trainStart, trainEnd, false);
+        double var = varN / (trainEnd - trainStart + 1);
+        double devN = heldOut -> getSquaredDeviations(start, end, mean);
+        int N = end - start + 1;
+        if(var <= 0) return INFINITY;
+        return N * (log(var) + log(2*M_PI)) + devN / var;
+    }
+
+    std::vector<std::string> getParamNames(){
+        return meanvar_norm::param_names;
+    }
+
+    int getParamCount(){
+        return 4;
+    }
+)
+
+DISTRIBUTION(negbin, CumsumSquared,
+
+    static std::string description;
+
+    template<class S>
+    double cost(S * stats, int start, int end){
+        double lSum = stats -> getLinearSum(start, end);
+        double mean = stats -> getMean(start, end);
+        double varN = stats -> getVarianceN(start, end, false);
+        int N = end - start + 1;
+        if (varN <= 0) return INFINITY;
+        double var = varN/N;
+        double r_dispersion = fabs(pow(mean, 2)/(var-mean));
+        double p_success = mean/var;
+        return (lSum * log(1-p_success) + N * r_dispersion * log(p_success));
+    }
+
+    void calcParams(int start, int mid, int end, double * row){
+        double meanLeft = this -> summaryStatistics -> getMean(start, mid);
+        double meanRight = this -> summaryStatistics -> getMean(mid + 1, end);
+        double varLeft = this -> summaryStatistics -> getVarianceN(start, mid, false)/(mid - start + 1);
+        double varRight = this -> summaryStatistics -> getVarianceN(mid + 1, end, false)/(end - mid + 1);
+        double probLeft = meanLeft/varLeft;
+        double probRight = meanRight/varRight;
+
+        row[5] = probLeft;
+        row[6] = probRight;
+    }
+
+    std::vector<std::string> getParamNames(){
+        return negbin::param_names;
+    }
+
+    int getParamCount(){
+        return 2;
+    }
+)
+
+
+DISTRIBUTION(poisson, CumsumSquared,
+
+    static std::string description;
+
+    static const SplitCost splitCost = POISSON_COST;
+
+    static const bool runSplits = true;
+
+    template<class S>
+    double cost(S * stats, int start, int end){
+        double lSum = stats -> getLinearSum(start, end);
+        int N = end - start + 1;
+        return - lSum * (log(lSum) - log(N));
+    }
+
+    void addConstant(const double * data, int count){
+        for (int i = 0; i < count; i++) this -> constant += data[i] + (long double) lgamma(data[i]);
+    }
+
+    void calcParams(int start, int mid, int end, double * row){
+        double rateLeft = this -> summaryStatistics -> getMean(start, mid);
+        double rateRight = this -> summaryStatistics -> getMean(mid + 1, end);
+
+        row[5] = rateLeft;
+        row[6] = rateRight;
+    }
+
+    double heldOutCost(Cumsum * heldOut, int start, int end, int trainStart, int trainEnd){
+        double rate = this -> summaryStatistics -> getMean(trainStart, trainEnd);
+        double lSum = heldOut -> getLinearSum(start, end);
+        int N = end - start + 1;
+        if (lSum == 0) return N * rate; // Every observation is zero, so the rate can also be zero
+        return N * rate - lSum - lSum * log(rate); // The constant terms include lSum
+    }
+
+    std::vector<std::string> getParamNames(){
+        return poisson::param_names;
+    }
+
+    int getParamCount(){
+        return 2;
+    }
+)
+
+
+DISTRIBUTION(exponential, Cumsum,
+
+    static std::string description;
+
+    static const SplitCost splitCost = EXPONENTIAL_COST;
+
+    static const bool runSplits = true;
+
+    template<class S>
+    double cost(S * stats, int start, int end){
+        int T = end - start + 1;
+        double lSum = stats -> getLinearSum(start, end);
+        return - T * (log(T) - log(lSum)); // -1 -> -T on R code
+    }
+
+    void addConstant(const double * data, int count){
+        (void) data;
+        this -> constant += count;
+    }
+
+    void calcParams(int start, int mid, int end, double * row){
+        double lSumLeft = this -> summaryStatistics -> getLinearSum(start, mid);
+        double lSumRight = this -> summaryStatistics -> getLinearSum(mid + 1, end);
+        double rateLeft = lSumLeft == INFINITY? INFINITY : (mid - start + 1) / lSumLeft;
+        double rateRight = lSumRight == INFINITY? INFINITY : (end - mid + 1) / lSumRight;
+
+        row[5] = rateLeft;
+        row[6] = rateRight;
+    }
+
+    double heldOutCost(Cumsum * heldOut, int start, int end, int trainStart, int trainEnd){
+        double rate = (trainEnd - trainStart + 1) / this -> summaryStatistics -> getLinearSum(trainStart, trainEnd);
+        int N = end - start + 1;
+        return - N * log(rate) + rate * heldOut -> getLinearSum(start, end) - N; // The constant terms include N
+    }
+
+    std::vector<std::string> getParamNames(){
+        return poisson::param_names;
+    }
+
+    int getParamCount(){
+        return 2;
+    }
+)
+
+
+MULTI_DISTRIBUTION(multi_mean_norm, LINEAR_CHANNEL_SUMS,
+
+    static std::string description;
+
+    double cost(MultiCumsum * stats, int start, int end){
+        double N = end - start + 1;
+        return - stats -> getSquaredLinearSums(start, end)/N;
+    }
+
+    double modelCost(int start, int end){
+        MultiCumsum * stats = this -> statistics();
+        double lSums = 0;
+        for (int c = 0; c < stats -> getChannels(); c++)
+            lSums += pow(stats -> getChannelSum(start, end, c), 2);
+        double N = end - start + 1;
+        return - lSums/N;
+    }
+
+    void addConstant(const double * data, int count){
+        int channels = this -> statistics() -> getChannels();
+        for (int i = 0; i < count; i++){
+            for (int c = 0; c < channels; c++){
+                double value = data[(size_t) c * count + i];
+                this -> constant += value * value;
+            }
+        }
+    }
+
+    void calcParams(int start, int mid, int end, double * row){
+        MultiCumsum * stats = this -> statistics();
+        int channels = stats -> getChannels();
+        for (int c = 0; c < channels; c++){
+            row[5 + c] = stats -> getChannelMean(start, mid, c);
+            row[5 + channels + c] = stats -> getChannelMean(mid + 1, end, c);
+        }
+    }
+
+    std::vector<std::string> getParamNames(){
+        return this -> channelNames(multi_mean_norm::param_names);
+    }
+
+    int getParamCount(){
+        return 2 * this -> statistics() -> getChannels();
+    }
+)
+
+
+MULTI_DISTRIBUTION(multi_meanvar_norm, QUADRATIC_CHANNEL_SUMS,
+
+    static std::string description;
+
+    double cost(MultiCumsum * stats, int start, int end){
+        double logVariances = stats -> getLogVariances(start, end);
+        if(logVariances == INFINITY) return INFINITY;
+        int N = end - start + 1;
+        int channels = stats -> getChannels();
+        return N*(logVariances + channels*log(2*M_PI) + channels);
+    }
+
+    void calcParams(int start, int mid, int end, double * row){
+        MultiCumsum * stats = this -> statistics();
+        int channels = stats -> getChannels();
+        for (int c = 0; c < channels; c++){
+            row[5 + c] = stats -> getChannelMean(start, mid, c);
+            row[5 + channels + c] = stats -> getChannelMean(mid + 1, end, c);
+            row[5 + 2 * channels + c] = stats -> getChannelVarianceN(start, mid, c) / (mid - start + 1);
+            row[5 + 3 * channels + c] = stats -> getChannelVarianceN(mid + 1, end, c) / (end - mid);
+        }
+    }
+
+    std::vector<std::string> getParamNames(){
+        return this -> channelNames(multi_meanvar_norm::param_names);
+    }
+
+    int getParamCount(){
+        return 4 * this -> statistics() -> getChannels();
+    }
+)
+
+
+MULTI_DISTRIBUTION(multi_meancov_norm, CROSS_CHANNEL_SUMS,
+
+    static std::string description;
+
+    // The cost is N * log(det(S / N)) plus the constant terms, where S is the matrix of the centered cross products of
+    // the segment. Its determinant is the product of the pivots of its Cholesky decomposition, which is computed in a
+    // buffer of each thread, and it is undefined if S is not positive definite (i.e. if N <= channels).
+    double cost(MultiCumsum * stats, int start, int end){
+        int channels = stats -> getChannels();
+        const double * firstLinear = stats -> linearRow(start);
+        const double * lastLinear = stats -> linearRow(end + 1);
+        const double * firstCross = stats -> crossRow(start);
+        const double * lastCross = stats -> crossRow(end + 1);
+        double N = end - start + 1;
+        thread_local std::vector<double> lower; // The lower triangle of S, by rows
+        lower.resize((size_t) channels * channels);
+        int k = 0;
+        for (int c = 0; c < channels; c++){
+            double lSum = lastLinear[c] - firstLinear[c];
+            for (int e = c; e < channels; e++){
+                double crossSum = lastCross[k] - firstCross[k];
+                lower[(size_t) e * channels + c] = crossSum - lSum*(lastLinear[e] - firstLinear[e])/N;
+                k++;
+            }
+        }
+        double logDet = 0;
+        for (int j = 0; j < channels; j++){
+            double * rowJ = &lower[(size_t) j * channels];
+            for (int i = j; i < channels; i++){
+                double * rowI = &lower[(size_t) i * channels];
+                double value = rowI[j];
+                for (int p = 0; p < j; p++) value -= rowI[p] * rowJ[p];
+                rowI[j] = value;
+            }
+            double pivot = rowJ[j];
+            if(pivot <= 0) return INFINITY;
+            logDet += log(pivot/N);
+            double root = sqrt(pivot);
+            rowJ[j] = root;
+            for (int i = j + 1; i < channels; i++) lower[(size_t) i * channels + j] /= root;
+        }
+        return N*(logDet + channels*log(2*M_PI) + channels);
+    }
+
+    // The parameters are the means and variances of every channel, as in multi_meanvar_norm. The covariances between
+    // the channels are part of the cost but not of the parameters, since their number grows with the square of the
+    // number of channels.
+    void calcParams(int start, int mid, int end, double * row){
+        MultiCumsum * stats = this -> statistics();
+        int channels = stats -> getChannels();
+        for (int c = 0; c < channels; c++){
+            row[5 + c] = stats -> getChannelMean(start, mid, c);
+            row[5 + channels + c] = stats -> getChannelMean(mid + 1, end, c);
+            row[5 + 2 * channels + c] = stats -> getChannelVarianceN(start, mid, c) / (mid - start + 1);
+            row[5 + 3 * channels + c] = stats -> getChannelVarianceN(mid + 1, end, c) / (end - mid);
+        }
+    }
+
+    std::vector<std::string> getParamNames(){
+        return this -> channelNames(multi_meancov_norm::param_names);
+    }
+
+    int getParamCount(){
+        return 4 * this -> statistics() -> getChannels();
+    }
+)
+
+#endif // BINSEG_DISTRIBUTIONS_H
@@ -2,6 +2,9 @@
 // Created by Diego Urgell on 15/06/21.
 //
 
+#ifndef BINSEG_GENERIC_FACTORY_H
+#define BINSEG_GENERIC_FACTORY_H
+
 #include <memory>
 #include <map>
 #include <string>
@@ -90,3 +93,5 @@ public:
 
     static bool is_registered;
 };
+
+#endif // BINSEG_GENERIC_FACTORY_H
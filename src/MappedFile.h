@@ -0,0 +1,169 @@
+#ifndef BINSEG_MAPPED_FILE_H
+#define BINSEG_MAPPED_FILE_H
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/**
+ * A read-only memory mapping of a whole file, so that data larger than the available memory can be read sequentially
+ * without loading it. The operating system pages it in on demand. Memory mapping is not supported on Windows.
+ */
+class MappedFile {
+
+private:
+
+    const unsigned char * bytes;
+    size_t length;
+
+public:
+
+    /**
+     * Maps the file into memory.
+     * @param path The path of the file.
+     */
+    explicit MappedFile(const std::string &path){
+        this -> bytes = nullptr;
+        this -> length = 0;
+#ifdef _WIN32
+        (void) path;
+        throw "Memory mapped files are not supported on Windows";
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw "The file could not be opened";
+        struct stat info;
+        if (fstat(fd, &info) != 0){
+            close(fd);
+            throw "The size of the file could not be read";
+        }
+        this -> length = info.st_size;
+        if (this -> length > 0){
+            void * mapping = mmap(nullptr, this -> length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED){
+                close(fd);
+                throw "The file could not be mapped into memory";
+            }
+            madvise(mapping, this -> length, MADV_SEQUENTIAL);
+            this -> bytes = static_cast<const unsigned char *>(mapping);
+        }
+        close(fd); // The mapping remains valid
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator = (const MappedFile&) = delete;
+
+    ~MappedFile(){
+#ifndef _WIN32
+        if (this -> bytes != nullptr) munmap(const_cast<unsigned char *>(this -> bytes), this -> length);
+#endif
+    }
+
+    const unsigned char * data() const {
+        return this -> bytes;
+    }
+
+    size_t size() const {
+        return this -> length;
+    }
+
+    /**
+     * Decodes count little-endian values of type T (float or double) starting at the given value index.
+     * @param first The index of the first value to decode.
+     * @param count The number of values
+     * @param out The decoded values.
+     */
+    template<class T>
+    void decode(size_t first, int count, double * out) const {
+        const uint16_t one = 1;
+        const bool littleEndian = *reinterpret_cast<const unsigned char *>(&one) == 1;
+        const unsigned char * source = this -> bytes + first * sizeof(T);
+        for (int i = 0; i < count; i++){
+            unsigned char value[sizeof(T)];
+            if (littleEndian) memcpy(value, source + i * sizeof(T), sizeof(T));
+            else for (size_t b = 0; b < sizeof(T); b++) value[b] = source[i * sizeof(T) + sizeof(T) - 1 - b];
+            T decoded;
+            memcpy(&decoded, value, sizeof(T));
+            out[i] = decoded;
+        }
+    }
+};
+
+
+/**
+ * Allocator for the prefix sums, which places them in memory mapped scratch files when a scratch directory is given.
+ * Each allocation creates a new file, which is unlinked right away so that it is removed once it is unmapped (or if the
+ * process ends). The pages are written back to disk by the operating system when memory is needed. Without a scratch
+ * directory, it behaves as the standard allocator.
+ * @tparam T The type of the elements.
+ */
+template<class T>
+class ScratchAllocator {
+
+public:
+
+    typedef T value_type;
+
+    std::string directory; // Empty for regular memory
+
+    ScratchAllocator() = default;
+
+    explicit ScratchAllocator(const std::string &directory): directory(directory) {}
+
+    template<class U>
+    ScratchAllocator(const ScratchAllocator<U> &other): directory(other.directory) {}
+
+    T * allocate(size_t n){
+        if (this -> directory.empty()) return static_cast<T *>(::operator new(n * sizeof(T)));
+#ifdef _WIN32
+        throw "Scratch files are not supported on Windows";
+#else
+        std::string path = this -> directory + "/binseg-XXXXXX";
+        int fd = mkstemp(&path[0]);
+        if (fd < 0) throw "The scratch file could not be created";
+        unlink(path.c_str());
+        if (ftruncate(fd, n * sizeof(T)) != 0){
+            close(fd);
+            throw "The scratch file could not be resized";
+        }
+        void * mapping = mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) throw "The scratch file could not be mapped into memory";
+        return static_cast<T *>(mapping);
+#endif
+    }
+
+    void deallocate(T * p, size_t n){
+        if (this -> directory.empty()) ::operator delete(p);
+#ifndef _WIN32
+        else munmap(p, n * sizeof(T));
+#endif
+    }
+
+    // Scratch files must be released by an allocator of the same kind.
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+};
+
+template<class T, class U>
+bool operator == (const ScratchAllocator<T> &a, const ScratchAllocator<U> &b){
+    return a.directory == b.directory;
+}
+
+template<class T, class U>
+bool operator != (const ScratchAllocator<T> &a, const ScratchAllocator<U> &b){
+    return a.directory != b.directory;
+}
+
+#endif // BINSEG_MAPPED_FILE_H
@@ -0,0 +1,107 @@
+#ifndef BINSEG_MODEL_TABLE_H
+#define BINSEG_MODEL_TABLE_H
+
+#include <cmath>
+#include <vector>
+
+/**
+ * The summary of the segmentation models computed by an algorithm. Each model is stored in a row, which holds the index
+ * of the model, the new changepoint, the invalidation info of the split, the cost, and then the parameters estimated by
+ * the distribution. The rows are stored contiguously and grow on demand, so that the memory used depends on the number
+ * of models that are actually found, rather than on the maximum number of changepoints. The split that created each
+ * model is also kept, so that the parameters are estimated once the search is over (see Algorithm::completeModels).
+ */
+class ModelTable {
+
+private:
+
+    std::vector<double> values; // Row major
+    std::vector<int> splits; // The start, changepoint and end of the split of every model
+    int numCols = 0;
+
+public:
+
+    ModelTable() = default;
+
+    /**
+     * Removes every model.
+     * @param numCols The number of columns of each row.
+     * @param expectedRows The number of rows to reserve memory for.
+     */
+    void reset(int numCols, int expectedRows){
+        this -> numCols = numCols;
+        this -> values.clear();
+        this -> values.reserve((size_t) numCols * expectedRows);
+        this -> splits.clear();
+        this -> splits.reserve((size_t) 3 * expectedRows);
+    }
+
+    /**
+     * Appends a new row filled with zeros.
+     * @param start The start of the split segment (inclusive).
+     * @param mid The changepoint.
+     * @param end The end of the split segment (inclusive).
+     * @return A pointer to the new row. It is invalidated when another row is added.
+     */
+    double * addRow(int start, int mid, int end){
+        this -> values.resize(this -> values.size() + this -> numCols, 0);
+        this -> splits.insert(this -> splits.end(), {start, mid, end});
+        return &this -> values[this -> values.size() - this -> numCols];
+    }
+
+    /**
+     * Removes the rows after the first numRows ones.
+     */
+    void truncate(int numRows){
+        this -> values.resize((size_t) numRows * this -> numCols);
+        this -> splits.resize((size_t) 3 * numRows);
+    }
+
+    /**
+     * Changes the split that created the model of a row.
+     * @param i The index of the row.
+     */
+    void setSplit(int i, int start, int mid, int end){
+        this -> splits[3 * i] = start;
+        this -> splits[3 * i + 1] = mid;
+        this -> splits[3 * i + 2] = end;
+    }
+
+    double * row(int i){
+        return &this -> values[(size_t) i * this -> numCols];
+    }
+
+    int getNumRows(){
+        return this -> numCols == 0 ? 0 : this -> values.size() / this -> numCols;
+    }
+
+    int getNumCols(){
+        return this -> numCols;
+    }
+
+    size_t getBytes(){
+        return this -> values.capacity() * sizeof(double) + this -> splits.capacity() * sizeof(int);
+    }
+
+    const int * getSplits(){
+        return this -> splits.data();
+    }
+
+    /**
+     * Copies a column of the table. The values that are not finite (undefined parameters and costs) are replaced by
+     * missing.
+     * @param j The index of the column.
+     * @param out The destination, with space for getNumRows() values.
+     * @param missing The value that represents an undefined entry (i.e. NA_REAL).
+     */
+    void copyColumn(int j, double * out, double missing = NAN){
+        int numRows = this -> getNumRows();
+        const double * column = this -> values.data() + j;
+        for (int i = 0; i < numRows; i++){
+            double value = column[(size_t) i * this -> numCols];
+            out[i] = std::isfinite(value) ? value : missing;
+        }
+    }
+};
+
+#endif // BINSEG_MODEL_TABLE_H
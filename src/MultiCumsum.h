@@ -0,0 +1,312 @@
+#ifndef BINSEG_MULTI_CUMSUM_H
+#define BINSEG_MULTI_CUMSUM_H
+
+#include <string.h>
+#include "Cumsum.h"
+#include "SplitScan.h"
+
+/**
+ * The sums that the multivariate summary statistics store for every channel, besides the linear sums. The quadratic
+ * sums are the ones of each channel alone, while the cross products are the ones of every pair of channels (including
+ * each channel with itself), as required to estimate a full covariance matrix.
+ */
+enum ChannelSums {LINEAR_CHANNEL_SUMS, QUADRATIC_CHANNEL_SUMS, CROSS_CHANNEL_SUMS};
+
+/**
+ * Summary statistics of data with several channels observed at the same times, such as telemetry. The data is given as
+ * a column-major matrix with one column per channel, as in R. The prefix sums of all the channels are interleaved: the
+ * sums of every channel up to an observation are contiguous, and there is a row of zeros before the first observation.
+ * Then, the sums of a segment over all the channels are read from two rows without any branch, and the costs of the
+ * multivariate distributions are summed across the channels in a single loop (see MultiKernel). The cross products take
+ * channels * (channels + 1) / 2 values per observation, so they are only stored for the distributions that need them.
+ * The sums are always stored in memory as doubles, and the runs and bounds of Cumsum are ignored.
+ */
+class MultiCumsum: public Cumsum {
+
+private:
+
+    ChannelSums kind;
+    int channels = 1;
+    int crossWidth = 1; // The number of cross products of each row
+    bool compensated = false;
+    std::vector<double> shifts; // The first observation of every channel if the data is centered, and 0 otherwise
+    std::vector<double> linearSums; // One row of channels prefix sums for each observation, plus the row of zeros
+    std::vector<double> quadraticSums;
+    std::vector<double> crossSums; // The upper triangle of the cross products of every row, by rows
+    std::vector<RunningSum> linearTotals;
+    std::vector<RunningSum> quadraticTotals;
+    std::vector<RunningSum> crossTotals;
+
+    void resetTotals(std::vector<RunningSum> &totals, std::vector<double> &sums, int width){
+        RunningSum total;
+        total.compensated = this -> compensated;
+        totals.assign(width, total);
+        sums.assign(width, 0);
+    }
+
+    void storeTotals(const std::vector<RunningSum> &totals, std::vector<double> &sums){
+        for (const RunningSum &total: totals) sums.push_back(total.value());
+    }
+
+    // Moves the exponents of the lanes to the returned total, leaving their mantissas in [0.5, 1).
+    static int renormalize(Double4 &products){
+        int total = 0;
+        for (int k = 0; k < 4; k++){
+            int exponent;
+            products[k] = frexp(products[k], &exponent);
+            total += exponent;
+        }
+        return total;
+    }
+
+    // Same as getLogVariances, with the logarithms added one by one.
+    double sumLogVariances(int start, int end) const {
+        int N = end - start + 1;
+        double logSum = 0;
+        for (int c = 0; c < this -> channels; c++){
+            double lSum = this -> linearRow(end + 1)[c] - this -> linearRow(start)[c];
+            double varN = (this -> quadraticRow(end + 1)[c] - this -> quadraticRow(start)[c]) - (lSum * lSum / N);
+            if (varN <= 0) return INFINITY;
+            logSum += log(varN / N);
+        }
+        return logSum;
+    }
+
+public:
+
+    explicit MultiCumsum(ChannelSums kind = LINEAR_CHANNEL_SUMS){
+        this -> kind = kind;
+        this -> clear();
+    }
+
+    /**
+     * Sets the number of channels of the data. It must be called before init.
+     * @param channels The number of channels, which is the number of columns of the data.
+     */
+    void setChannels(int channels){
+        if (channels < 1) throw "At least one channel is needed";
+        this -> channels = channels;
+        this -> crossWidth = channels * (channels + 1) / 2;
+        this -> clear();
+    }
+
+    int getChannels() const {
+        return this -> channels;
+    }
+
+    void setStable(bool centered){
+        this -> centered = centered;
+        this -> compensated = true;
+        this -> clear();
+    }
+
+    void setStorage(StorageType type){
+        if (type != DOUBLE_STORAGE) throw "The multivariate summary statistics are only stored as doubles";
+    }
+
+    void useScratch(const std::string &directory){
+        (void) directory;
+        throw "The multivariate summary statistics are only stored in memory";
+    }
+
+    void reserve(int length){
+        size_t rows = (size_t) length + 1;
+        this -> linearSums.reserve(rows * this -> channels);
+        if (this -> kind == QUADRATIC_CHANNEL_SUMS) this -> quadraticSums.reserve(rows * this -> channels);
+        if (this -> kind == CROSS_CHANNEL_SUMS) this -> crossSums.reserve(rows * this -> crossWidth);
+    }
+
+    void popFront(int count){
+        (void) count;
+        throw "The multivariate summary statistics do not support a sliding window";
+    }
+
+    size_t getBytes() const {
+        return (this -> linearSums.capacity() + this -> quadraticSums.capacity() + this -> crossSums.capacity()) *
+               sizeof(double);
+    }
+
+    /**
+     * Removes all the observations, keeping only the row of zeros.
+     */
+    void clear(){
+        this -> length = 0;
+        this -> shifts.assign(this -> channels, 0);
+        this -> resetTotals(this -> linearTotals, this -> linearSums, this -> channels);
+        if (this -> kind == QUADRATIC_CHANNEL_SUMS)
+            this -> resetTotals(this -> quadraticTotals, this -> quadraticSums, this -> channels);
+        if (this -> kind == CROSS_CHANNEL_SUMS)
+            this -> resetTotals(this -> crossTotals, this -> crossSums, this -> crossWidth);
+    }
+
+    /**
+     * Computes the prefix sums of the data.
+     * @param data The column-major matrix of data, with one column per channel.
+     * @param length The number of observations, which is the number of rows of the data.
+     */
+    void init(const double *data, const int length){
+        this -> clear();
+        this -> reserve(length);
+        this -> append(data, length);
+    }
+
+    /**
+     * Appends new observations to the end of the data.
+     * @param data The column-major matrix of the new observations, with one column per channel.
+     * @param count The number of new observations, which is the number of rows of the data.
+     */
+    void append(const double *data, const int count){
+        if (this -> length == 0 && this -> centered && count > 0)
+            for (int c = 0; c < this -> channels; c++) this -> shifts[c] = data[(size_t) c * count];
+        std::vector<double> row(this -> channels);
+        for (int i = 0; i < count; i++){
+            for (int c = 0; c < this -> channels; c++) row[c] = data[(size_t) c * count + i] - this -> shifts[c];
+            for (int c = 0; c < this -> channels; c++) this -> linearTotals[c].add(row[c]);
+            this -> storeTotals(this -> linearTotals, this -> linearSums);
+            if (this -> kind == QUADRATIC_CHANNEL_SUMS){
+                for (int c = 0; c < this -> channels; c++) this -> quadraticTotals[c].add(row[c] * row[c]);
+                this -> storeTotals(this -> quadraticTotals, this -> quadraticSums);
+            }
+            if (this -> kind == CROSS_CHANNEL_SUMS){
+                int k = 0;
+                for (int c = 0; c < this -> channels; c++)
+                    for (int e = c; e < this -> channels; e++) this -> crossTotals[k++].add(row[c] * row[e]);
+                this -> storeTotals(this -> crossTotals, this -> crossSums);
+            }
+        }
+        this -> length += count;
+    }
+
+    /**
+     * The prefix sums of the centered data of every channel, for the first i observations. The sums of a segment are
+     * the difference of the rows of its end + 1 and its start.
+     * @param i The number of observations, from 0 to the length of the data.
+     */
+    const double * linearRow(int i) const {
+        return this -> linearSums.data() + (size_t) i * this -> channels;
+    }
+
+    /**
+     * Same as linearRow, for the sums of the squares. Only stored with QUADRATIC_CHANNEL_SUMS.
+     */
+    const double * quadraticRow(int i) const {
+        return this -> quadraticSums.data() + (size_t) i * this -> channels;
+    }
+
+    /**
+     * Same as linearRow, for the sums of the cross products, with the pairs of channels (c, e) such that c <= e ordered
+     * by c and then by e. Only stored with CROSS_CHANNEL_SUMS.
+     */
+    const double * crossRow(int i) const {
+        return this -> crossSums.data() + (size_t) i * this -> crossWidth;
+    }
+
+    /**
+     * Computes the sum over the channels of the squared linear sum of the centered data of a segment. The channels are
+     * accumulated in the four lanes of a vector (see Double4), so that the loop is vectorized without reassociating the
+     * sum, and the result does not depend on the instruction set.
+     * @param start inclusive
+     * @param end inclusive
+     */
+    double getSquaredLinearSums(int start, int end) const {
+        const double * first = this -> linearRow(start);
+        const double * last = this -> linearRow(end + 1);
+        Double4 partial = {0, 0, 0, 0};
+        int c = 0;
+        for (; c + 4 <= this -> channels; c += 4){
+            Double4 a, b;
+            memcpy(&a, first + c, sizeof(Double4));
+            memcpy(&b, last + c, sizeof(Double4));
+            Double4 diff = b - a;
+            partial += diff * diff;
+        }
+        double sum = (partial[0] + partial[1]) + (partial[2] + partial[3]);
+        for (; c < this -> channels; c++){
+            double diff = last[c] - first[c];
+            sum += diff * diff;
+        }
+        return sum;
+    }
+
+    /**
+     * Computes the sum over the channels of the logarithm of the variance of a segment, or INFINITY if the variance of
+     * any channel is not positive. Only available with QUADRATIC_CHANNEL_SUMS. The variances of four channels are
+     * computed at a time in the lanes of a vector, and multiplied into four partial products, whose exponents are moved
+     * apart (see frexp) every four multiplications, so that a single logarithm is evaluated per segment. The variances
+     * are bounded so that the partial products never leave the range of the normal doubles, otherwise the logarithms
+     * are added one by one.
+     * @param start inclusive
+     * @param end inclusive
+     */
+    double getLogVariances(int start, int end) const {
+        const double * firstLinear = this -> linearRow(start);
+        const double * lastLinear = this -> linearRow(end + 1);
+        const double * firstQuadratic = this -> quadraticRow(start);
+        const double * lastQuadratic = this -> quadraticRow(end + 1);
+        const double bound = ldexp(1, 255);
+        int N = end - start + 1;
+        double inverse = 1.0 / N;
+        Double4 inverses = {inverse, inverse, inverse, inverse};
+        Double4 products = {1, 1, 1, 1};
+        int exponent = 0;
+        int c = 0;
+        for (; c + 4 <= this -> channels; c += 4){
+            Double4 a, b, p, q;
+            memcpy(&a, firstLinear + c, sizeof(Double4));
+            memcpy(&b, lastLinear + c, sizeof(Double4));
+            memcpy(&p, firstQuadratic + c, sizeof(Double4));
+            memcpy(&q, lastQuadratic + c, sizeof(Double4));
+            Double4 lSum = b - a;
+            Double4 varN = (q - p) - lSum * lSum * inverses;
+            Double4 ratio = varN * inverses;
+            for (int k = 0; k < 4; k++){
+                if (varN[k] <= 0) return INFINITY;
+                if (ratio[k] > bound || ratio[k] < 1 / bound) return this -> sumLogVariances(start, end);
+            }
+            products *= ratio;
+            if (c % 16 == 12) exponent += this -> renormalize(products);
+        }
+        exponent += this -> renormalize(products);
+        double logSum = log((products[0] * products[1]) * (products[2] * products[3])) + exponent * M_LN2;
+        for (; c < this -> channels; c++){
+            double lSum = lastLinear[c] - firstLinear[c];
+            double varN = (lastQuadratic[c] - firstQuadratic[c]) - (lSum * lSum / N);
+            if (varN <= 0) return INFINITY;
+            logSum += log(varN / N);
+        }
+        return logSum;
+    }
+
+    /**
+     * @return The linear sum of the original data of a channel from start to end (inclusive).
+     */
+    double getChannelSum(int start, int end, int channel) const {
+        if (start > end) return INFINITY;
+        double centeredSum = this -> linearRow(end + 1)[channel] - this -> linearRow(start)[channel];
+        return centeredSum + (end - start + 1) * this -> shifts[channel];
+    }
+
+    double getChannelMean(int start, int end, int channel) const {
+        return this -> getChannelSum(start, end, channel) / (end - start + 1);
+    }
+
+    /**
+     * @return The variance of a channel from start to end (inclusive) multiplied by the length of the segment, from the
+     * quadratic sums or from the cross products.
+     */
+    double getChannelVarianceN(int start, int end, int channel) const {
+        if (start > end) return INFINITY;
+        double lSum = this -> linearRow(end + 1)[channel] - this -> linearRow(start)[channel];
+        double sSum;
+        if (this -> kind == CROSS_CHANNEL_SUMS){
+            int k = channel * this -> channels - channel * (channel - 1) / 2; // The position of (channel, channel)
+            sSum = this -> crossRow(end + 1)[k] - this -> crossRow(start)[k];
+        }
+        else {
+            sSum = this -> quadraticRow(end + 1)[channel] - this -> quadraticRow(start)[channel];
+        }
+        return sSum - lSum * lSum / (end - start + 1);
+    }
+};
+
+#endif // BINSEG_MULTI_CUMSUM_H
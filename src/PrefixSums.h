@@ -0,0 +1,226 @@
+#ifndef BINSEG_PREFIX_SUMS_H
+#define BINSEG_PREFIX_SUMS_H
+
+#include <vector>
+#include <string>
+#include "MappedFile.h"
+
+// Forces the inlining of the storage specific queries into the split scans, where GCC otherwise considers them too
+// large because of their error paths.
+#if defined(__GNUC__)
+#define SUMS_INLINE inline __attribute__((always_inline))
+#else
+#define SUMS_INLINE inline
+#endif
+
+template<class T>
+using ScratchVector = std::vector<T, ScratchAllocator<T>>; // In memory, or in scratch files if requested
+
+/**
+ * The encodings of the prefix sums. DOUBLE_STORAGE keeps every prefix sum as a double (8 bytes per observation).
+ * BLOCK_STORAGE keeps a double anchor every PrefixSums::blockSize observations, and the difference between each prefix
+ * sum and the anchor of its block as a float (about 4.1 bytes per observation). FLOAT_STORAGE keeps every prefix sum as
+ * a float (4 bytes per observation).
+ */
+enum StorageType {DOUBLE_STORAGE, BLOCK_STORAGE, FLOAT_STORAGE};
+
+/**
+ * Sequence of prefix sums with a configurable encoding, so that very long series can be segmented with half
+ * of the memory. The values are appended exactly, and only rounded when they are stored:
+ *  - DOUBLE_STORAGE returns the values as appended.
+ *  - BLOCK_STORAGE has an absolute error of at most 2^-24 * |value - anchor|, which is bounded by 2^-24 * L * max|x|,
+ *    where x are the summed (possibly centered) observations and L is the number of observations of a block. It is
+ *    blockSize (about 3.8e-6 * max|x|) when every value is one observation, but it is the total length of blockSize
+ *    runs when the values are stored once per run (see Cumsum::useRuns), so the bound grows with the run lengths.
+ *  - FLOAT_STORAGE has a relative error of at most 2^-24 (about 6e-8), so its absolute error grows with the value.
+ * Only DOUBLE_STORAGE exposes the raw values to the vectorized kernels.
+ *
+ * With DOUBLE_STORAGE, the oldest values can also be removed in constant time (see popFront), so that the sequence
+ * holds the prefix sums of a sliding window. The removed values stay in memory until the next rebase, and the value
+ * before the first one (the origin, which is 0 until a value is removed) is always stored, so the kernels can read it
+ * at index -1.
+ */
+class PrefixSums {
+
+private:
+
+    StorageType type = DOUBLE_STORAGE;
+    ScratchVector<double> values; // Every value (DOUBLE_STORAGE), or the anchor of every block (BLOCK_STORAGE)
+    ScratchVector<float> singles; // The offsets from the anchors (BLOCK_STORAGE), or every value (FLOAT_STORAGE)
+    size_t count = 0;
+    size_t first = 1; // The index of the first value in values (DOUBLE_STORAGE), after the origin
+
+    /**
+     * Discards the stored values, keeping only the origin at 0.
+     */
+    void reset(){
+        this -> values.assign(this -> type == DOUBLE_STORAGE ? 1 : 0, 0);
+        this -> singles.clear();
+        this -> first = 1;
+        this -> count = 0;
+    }
+
+public:
+
+    PrefixSums(){
+        this -> reset();
+    }
+
+    static const int blockSize = 64;
+
+    /**
+     * @param name One of "double", "block" or "float".
+     * @return The corresponding StorageType.
+     */
+    static StorageType parseType(const std::string &name){
+        if (name == "double") return DOUBLE_STORAGE;
+        if (name == "block") return BLOCK_STORAGE;
+        if (name == "float") return FLOAT_STORAGE;
+        throw "Unknown storage type";
+    }
+
+    /**
+     * Changes the encoding. The stored values are discarded.
+     */
+    void setType(StorageType type){
+        this -> type = type;
+        this -> clear();
+    }
+
+    /**
+     * Places the values in memory mapped scratch files in the given directory. The stored values are discarded.
+     */
+    void useScratch(const std::string &directory){
+        this -> values = ScratchVector<double>(ScratchAllocator<double>(directory));
+        this -> singles = ScratchVector<float>(ScratchAllocator<float>(directory));
+        this -> reset();
+    }
+
+    void reserve(size_t length){
+        if (this -> type == DOUBLE_STORAGE) this -> values.reserve(this -> first + length);
+        else this -> singles.reserve(length);
+        if (this -> type == BLOCK_STORAGE) this -> values.reserve(length / blockSize + 1);
+    }
+
+    void clear(){
+        this -> reset();
+    }
+
+    void push_back(double value){
+        switch (this -> type) {
+            case DOUBLE_STORAGE:
+                this -> values.push_back(value);
+                break;
+            case BLOCK_STORAGE:
+                if (this -> count % blockSize == 0) this -> values.push_back(value);
+                this -> singles.push_back((float) (value - this -> values.back()));
+                break;
+            default:
+                this -> singles.push_back((float) value);
+        }
+        this -> count++;
+    }
+
+    /**
+     * Replaces the last value, so that the prefix sum of a run of observations can be extended (see Cumsum::useRuns).
+     */
+    void setBack(double value){
+        switch (this -> type) {
+            case DOUBLE_STORAGE:
+                this -> values.back() = value;
+                break;
+            case BLOCK_STORAGE:
+                this -> singles.back() = (float) (value - this -> values.back());
+                break;
+            default:
+                this -> singles.back() = (float) value;
+        }
+    }
+
+    double operator[](size_t i) const {
+        return this -> type == DOUBLE_STORAGE ? this -> values[this -> first + i] : this -> compressed(i);
+    }
+
+    /**
+     * Same as operator[], for an encoding known at compile time.
+     * @tparam Compact Whether the encoding is BLOCK_STORAGE or FLOAT_STORAGE.
+     */
+    template<bool Compact>
+    SUMS_INLINE double at(size_t i) const {
+        return Compact ? this -> compressed(i) : this -> values[this -> first + i];
+    }
+
+    /**
+     * @return The value before the first one, that is, the last removed value (see popFront), or 0 if none was removed.
+     */
+    double origin() const {
+        return this -> type == DOUBLE_STORAGE ? this -> values[this -> first - 1] : 0;
+    }
+
+    /**
+     * Removes the given number of values from the start, in constant time. Only DOUBLE_STORAGE supports it.
+     * @param n The number of values to remove, at most size().
+     */
+    void popFront(size_t n){
+        if (this -> type != DOUBLE_STORAGE) throw "Only the prefix sums stored as doubles can be removed";
+        this -> first += n;
+        this -> count -= n;
+    }
+
+    /**
+     * @return The number of removed values that are still in memory.
+     */
+    size_t getRemoved() const {
+        return this -> first - 1;
+    }
+
+    /**
+     * Subtracts the origin from every value and releases the removed values, so that the prefix sums of a sliding
+     * window do not grow with the observations that left it. This takes linear time in the number of values.
+     * @return The origin that was subtracted.
+     */
+    double rebase(){
+        if (this -> type != DOUBLE_STORAGE || this -> first == 1) return 0;
+        double base = this -> values[this -> first - 1];
+        for (size_t i = 0; i < this -> count; i++) this -> values[i + 1] = this -> values[this -> first + i] - base;
+        this -> values[0] = 0;
+        this -> values.resize(this -> count + 1);
+        this -> first = 1;
+        return base;
+    }
+
+    double back() const {
+        return (*this)[this -> count - 1];
+    }
+
+    bool isCompact() const {
+        return this -> type != DOUBLE_STORAGE;
+    }
+
+    size_t size() const {
+        return this -> count;
+    }
+
+    /**
+     * @return The memory reserved for the values, in bytes.
+     */
+    size_t getBytes() const {
+        return this -> values.capacity() * sizeof(double) + this -> singles.capacity() * sizeof(float);
+    }
+
+    /**
+     * @return A pointer to the values, or nullptr if they are not stored as doubles. The origin is at index -1.
+     */
+    const double * data() const {
+        return this -> type == DOUBLE_STORAGE ? this -> values.data() + this -> first : nullptr;
+    }
+
+private:
+
+    double compressed(size_t i) const {
+        if (this -> type == BLOCK_STORAGE) return this -> values[i / blockSize] + this -> singles[i];
+        return this -> singles[i];
+    }
+};
+
+#endif // BINSEG_PREFIX_SUMS_H
@@ -11,8 +11,8 @@ Rcpp::Rostream<false>& Rcpp::Rcerr = Rcpp::Rcpp_cerr_get();
 #endif
 
 // rcpp_binseg
-Rcpp::NumericMatrix rcpp_binseg(Rcpp::NumericVector data, Rcpp::String algorithm, Rcpp::String distribution, int numCpts, int minSegLen);
-RcppExport SEXP _BinSeg_rcpp_binseg(SEXP dataSEXP, SEXP algorithmSEXP, SEXP distributionSEXP, SEXP numCptsSEXP, SEXP minSegLenSEXP) {
+Rcpp::List rcpp_binseg(Rcpp::NumericVector data, Rcpp::String algorithm, Rcpp::String distribution, int numCpts, int minSegLen, int numThreads, int parallelThreshold, int numIntervals, int seed, double penalty, bool stableSums, std::string storage, bool runLength, bool pruned, bool counters, SEXP progress, int searchStride, int searchWindow, bool resumable);
+RcppExport SEXP _BinSeg_rcpp_binseg(SEXP dataSEXP, SEXP algorithmSEXP, SEXP distributionSEXP, SEXP numCptsSEXP, SEXP minSegLenSEXP, SEXP numThreadsSEXP, SEXP parallelThresholdSEXP, SEXP numIntervalsSEXP, SEXP seedSEXP, SEXP penaltySEXP, SEXP stableSumsSEXP, SEXP storageSEXP, SEXP runLengthSEXP, SEXP prunedSEXP, SEXP countersSEXP, SEXP progressSEXP, SEXP searchStrideSEXP, SEXP searchWindowSEXP, SEXP resumableSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -21,7 +21,207 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< Rcpp::String >::type distribution(distributionSEXP);
     Rcpp::traits::input_parameter< int >::type numCpts(numCptsSEXP);
     Rcpp::traits::input_parameter< int >::type minSegLen(minSegLenSEXP);
-    rcpp_result_gen = Rcpp::wrap(rcpp_binseg(data, algorithm, distribution, numCpts, minSegLen));
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    Rcpp::traits::input_parameter< int >::type parallelThreshold(parallelThresholdSEXP);
+    Rcpp::traits::input_parameter< int >::type numIntervals(numIntervalsSEXP);
+    Rcpp::traits::input_parameter< int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< double >::type penalty(penaltySEXP);
+    Rcpp::traits::input_parameter< bool >::type stableSums(stableSumsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type storage(storageSEXP);
+    Rcpp::traits::input_parameter< bool >::type runLength(runLengthSEXP);
+    Rcpp::traits::input_parameter< bool >::type pruned(prunedSEXP);
+    Rcpp::traits::input_parameter< bool >::type counters(countersSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type progress(progressSEXP);
+    Rcpp::traits::input_parameter< int >::type searchStride(searchStrideSEXP);
+    Rcpp::traits::input_parameter< int >::type searchWindow(searchWindowSEXP);
+    Rcpp::traits::input_parameter< bool >::type resumable(resumableSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcpp_binseg(data, algorithm, distribution, numCpts, minSegLen, numThreads, parallelThreshold, numIntervals, seed, penalty, stableSums, storage, runLength, pruned, counters, progress, searchStride, searchWindow, resumable));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rcpp_stats_create
+SEXP rcpp_stats_create(bool stableSums, std::string storage, bool runLength, bool pruned);
+RcppExport SEXP _BinSeg_rcpp_stats_create(SEXP stableSumsSEXP, SEXP storageSEXP, SEXP runLengthSEXP, SEXP prunedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< bool >::type stableSums(stableSumsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type storage(storageSEXP);
+    Rcpp::traits::input_parameter< bool >::type runLength(runLengthSEXP);
+    Rcpp::traits::input_parameter< bool >::type pruned(prunedSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcpp_stats_create(stableSums, storage, runLength, pruned));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rcpp_binseg_shared
+Rcpp::List rcpp_binseg_shared(SEXP stats, Rcpp::NumericVector data, Rcpp::String algorithm, Rcpp::String distribution, int numCpts, int minSegLen, int numThreads, int parallelThreshold, int numIntervals, int seed, double penalty, bool counters, SEXP progress, int searchStride, int searchWindow, bool resumable);
+RcppExport SEXP _BinSeg_rcpp_binseg_shared(SEXP statsSEXP, SEXP dataSEXP, SEXP algorithmSEXP, SEXP distributionSEXP, SEXP numCptsSEXP, SEXP minSegLenSEXP, SEXP numThreadsSEXP, SEXP parallelThresholdSEXP, SEXP numIntervalsSEXP, SEXP seedSEXP, SEXP penaltySEXP, SEXP countersSEXP, SEXP progressSEXP, SEXP searchStrideSEXP, SEXP searchWindowSEXP, SEXP resumableSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type stats(statsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type data(dataSEXP);
+    Rcpp::traits::input_parameter< Rcpp::String >::type algorithm(algorithmSEXP);
+    Rcpp::traits::input_parameter< Rcpp::String >::type distribution(distributionSEXP);
+    Rcpp::traits::input_parameter< int >::type numCpts(numCptsSEXP);
+    Rcpp::traits::input_parameter< int >::type minSegLen(minSegLenSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    Rcpp::traits::input_parameter< int >::type parallelThreshold(parallelThresholdSEXP);
+    Rcpp::traits::input_parameter< int >::type numIntervals(numIntervalsSEXP);
+    Rcpp::traits::input_parameter< int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< double >::type penalty(penaltySEXP);
+    Rcpp::traits::input_parameter< bool >::type counters(countersSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type progress(progressSEXP);
+    Rcpp::traits::input_parameter< int >::type searchStride(searchStrideSEXP);
+    Rcpp::traits::input_parameter< int >::type searchWindow(searchWindowSEXP);
+    Rcpp::traits::input_parameter< bool >::type resumable(resumableSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcpp_binseg_shared(stats, data, algorithm, distribution, numCpts, minSegLen, numThreads, parallelThreshold, numIntervals, seed, penalty, counters, progress, searchStride, searchWindow, resumable));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rcpp_binseg_update
+Rcpp::List rcpp_binseg_update(SEXP state, int numCpts, int minSegLen, int numThreads, int parallelThreshold, bool counters, SEXP progress);
+RcppExport SEXP _BinSeg_rcpp_binseg_update(SEXP stateSEXP, SEXP numCptsSEXP, SEXP minSegLenSEXP, SEXP numThreadsSEXP, SEXP parallelThresholdSEXP, SEXP countersSEXP, SEXP progressSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type state(stateSEXP);
+    Rcpp::traits::input_parameter< int >::type numCpts(numCptsSEXP);
+    Rcpp::traits::input_parameter< int >::type minSegLen(minSegLenSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    Rcpp::traits::input_parameter< int >::type parallelThreshold(parallelThresholdSEXP);
+    Rcpp::traits::input_parameter< bool >::type counters(countersSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type progress(progressSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcpp_binseg_update(state, numCpts, minSegLen, numThreads, parallelThreshold, counters, progress));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rcpp_binseg_multi
+Rcpp::List rcpp_binseg_multi(Rcpp::NumericMatrix data, Rcpp::String algorithm, Rcpp::String distribution, int numCpts, int minSegLen, int numThreads, int parallelThreshold, int numIntervals, int seed, double penalty, bool stableSums);
+RcppExport SEXP _BinSeg_rcpp_binseg_multi(SEXP dataSEXP, SEXP algorithmSEXP, SEXP distributionSEXP, SEXP numCptsSEXP, SEXP minSegLenSEXP, SEXP numThreadsSEXP, SEXP parallelThresholdSEXP, SEXP numIntervalsSEXP, SEXP seedSEXP, SEXP penaltySEXP, SEXP stableSumsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type data(dataSEXP);
+    Rcpp::traits::input_parameter< Rcpp::String >::type algorithm(algorithmSEXP);
+    Rcpp::traits::input_parameter< Rcpp::String >::type distribution(distributionSEXP);
+    Rcpp::traits::input_parameter< int >::type numCpts(numCptsSEXP);
+    Rcpp::traits::input_parameter< int >::type minSegLen(minSegLenSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    Rcpp::traits::input_parameter< int >::type parallelThreshold(parallelThresholdSEXP);
+    Rcpp::traits::input_parameter< int >::type numIntervals(numIntervalsSEXP);
+    Rcpp::traits::input_parameter< int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< double >::type penalty(penaltySEXP);
+    Rcpp::traits::input_parameter< bool >::type stableSums(stableSumsSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcpp_binseg_multi(data, algorithm, distribution, numCpts, minSegLen, numThreads, parallelThreshold, numIntervals, seed, penalty, stableSums));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rcpp_binseg_file
+Rcpp::List rcpp_binseg_file(std::string path, std::string type, std::string scratch, Rcpp::String algorithm, Rcpp::String distribution, int numCpts, int minSegLen, int numThreads, int parallelThreshold, int numIntervals, int seed, double penalty, bool stableSums, std::string storage, bool runLength, bool pruned, int searchStride, int searchWindow);
+RcppExport SEXP _BinSeg_rcpp_binseg_file(SEXP pathSEXP, SEXP typeSEXP, SEXP scratchSEXP, SEXP algorithmSEXP, SEXP distributionSEXP, SEXP numCptsSEXP, SEXP minSegLenSEXP, SEXP numThreadsSEXP, SEXP parallelThresholdSEXP, SEXP numIntervalsSEXP, SEXP seedSEXP, SEXP penaltySEXP, SEXP stableSumsSEXP, SEXP storageSEXP, SEXP runLengthSEXP, SEXP prunedSEXP, SEXP searchStrideSEXP, SEXP searchWindowSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    Rcpp::traits::input_parameter< std::string >::type type(typeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type scratch(scratchSEXP);
+    Rcpp::traits::input_parameter< Rcpp::String >::type algorithm(algorithmSEXP);
+    Rcpp::traits::input_parameter< Rcpp::String >::type distribution(distributionSEXP);
+    Rcpp::traits::input_parameter< int >::type numCpts(numCptsSEXP);
+    Rcpp::traits::input_parameter< int >::type minSegLen(minSegLenSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    Rcpp::traits::input_parameter< int >::type parallelThreshold(parallelThresholdSEXP);
+    Rcpp::traits::input_parameter< int >::type numIntervals(numIntervalsSEXP);
+    Rcpp::traits::input_parameter< int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< double >::type penalty(penaltySEXP);
+    Rcpp::traits::input_parameter< bool >::type stableSums(stableSumsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type storage(storageSEXP);
+    Rcpp::traits::input_parameter< bool >::type runLength(runLengthSEXP);
+    Rcpp::traits::input_parameter< bool >::type pruned(prunedSEXP);
+    Rcpp::traits::input_parameter< int >::type searchStride(searchStrideSEXP);
+    Rcpp::traits::input_parameter< int >::type searchWindow(searchWindowSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcpp_binseg_file(path, type, scratch, algorithm, distribution, numCpts, minSegLen, numThreads, parallelThreshold, numIntervals, seed, penalty, stableSums, storage, runLength, pruned, searchStride, searchWindow));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rcpp_binseg_batch
+Rcpp::List rcpp_binseg_batch(Rcpp::NumericVector data, Rcpp::IntegerVector offsets, Rcpp::String algorithm, Rcpp::String distribution, int numCpts, int minSegLen, int numThreads, int numIntervals, int seed, bool stableSums);
+RcppExport SEXP _BinSeg_rcpp_binseg_batch(SEXP dataSEXP, SEXP offsetsSEXP, SEXP algorithmSEXP, SEXP distributionSEXP, SEXP numCptsSEXP, SEXP minSegLenSEXP, SEXP numThreadsSEXP, SEXP numIntervalsSEXP, SEXP seedSEXP, SEXP stableSumsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type data(dataSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type offsets(offsetsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::String >::type algorithm(algorithmSEXP);
+    Rcpp::traits::input_parameter< Rcpp::String >::type distribution(distributionSEXP);
+    Rcpp::traits::input_parameter< int >::type numCpts(numCptsSEXP);
+    Rcpp::traits::input_parameter< int >::type minSegLen(minSegLenSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    Rcpp::traits::input_parameter< int >::type numIntervals(numIntervalsSEXP);
+    Rcpp::traits::input_parameter< int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< bool >::type stableSums(stableSumsSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcpp_binseg_batch(data, offsets, algorithm, distribution, numCpts, minSegLen, numThreads, numIntervals, seed, stableSums));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rcpp_binseg_cv
+Rcpp::List rcpp_binseg_cv(Rcpp::NumericVector data, Rcpp::String algorithm, Rcpp::String distribution, int numCpts, int minSegLen, int numThreads, int numIntervals, int seed, bool stableSums);
+RcppExport SEXP _BinSeg_rcpp_binseg_cv(SEXP dataSEXP, SEXP algorithmSEXP, SEXP distributionSEXP, SEXP numCptsSEXP, SEXP minSegLenSEXP, SEXP numThreadsSEXP, SEXP numIntervalsSEXP, SEXP seedSEXP, SEXP stableSumsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type data(dataSEXP);
+    Rcpp::traits::input_parameter< Rcpp::String >::type algorithm(algorithmSEXP);
+    Rcpp::traits::input_parameter< Rcpp::String >::type distribution(distributionSEXP);
+    Rcpp::traits::input_parameter< int >::type numCpts(numCptsSEXP);
+    Rcpp::traits::input_parameter< int >::type minSegLen(minSegLenSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    Rcpp::traits::input_parameter< int >::type numIntervals(numIntervalsSEXP);
+    Rcpp::traits::input_parameter< int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< bool >::type stableSums(stableSumsSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcpp_binseg_cv(data, algorithm, distribution, numCpts, minSegLen, numThreads, numIntervals, seed, stableSums));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rcpp_stream_create
+SEXP rcpp_stream_create(Rcpp::String algorithm, Rcpp::String distribution, int numCpts, int minSegLen, int numIntervals, int seed, bool stableSums, int window);
+RcppExport SEXP _BinSeg_rcpp_stream_create(SEXP algorithmSEXP, SEXP distributionSEXP, SEXP numCptsSEXP, SEXP minSegLenSEXP, SEXP numIntervalsSEXP, SEXP seedSEXP, SEXP stableSumsSEXP, SEXP windowSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::String >::type algorithm(algorithmSEXP);
+    Rcpp::traits::input_parameter< Rcpp::String >::type distribution(distributionSEXP);
+    Rcpp::traits::input_parameter< int >::type numCpts(numCptsSEXP);
+    Rcpp::traits::input_parameter< int >::type minSegLen(minSegLenSEXP);
+    Rcpp::traits::input_parameter< int >::type numIntervals(numIntervalsSEXP);
+    Rcpp::traits::input_parameter< int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< bool >::type stableSums(stableSumsSEXP);
+    Rcpp::traits::input_parameter< int >::type window(windowSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcpp_stream_create(algorithm, distribution, numCpts, minSegLen, numIntervals, seed, stableSums, window));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rcpp_stream_append
+Rcpp::List rcpp_stream_append(SEXP stream, Rcpp::NumericVector data);
+RcppExport SEXP _BinSeg_rcpp_stream_append(SEXP streamSEXP, SEXP dataSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type stream(streamSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type data(dataSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcpp_stream_append(stream, data));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rcpp_stream_cache_size
+int rcpp_stream_cache_size(SEXP stream);
+RcppExport SEXP _BinSeg_rcpp_stream_cache_size(SEXP streamSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type stream(streamSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcpp_stream_cache_size(stream));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -47,7 +247,17 @@ END_RCPP
 }
 
 static const R_CallMethodDef CallEntries[] = {
-    {"_BinSeg_rcpp_binseg", (DL_FUNC) &_BinSeg_rcpp_binseg, 5},
+    {"_BinSeg_rcpp_binseg", (DL_FUNC) &_BinSeg_rcpp_binseg, 19},
+    {"_BinSeg_rcpp_stats_create", (DL_FUNC) &_BinSeg_rcpp_stats_create, 4},
+    {"_BinSeg_rcpp_binseg_shared", (DL_FUNC) &_BinSeg_rcpp_binseg_shared, 16},
+    {"_BinSeg_rcpp_binseg_update", (DL_FUNC) &_BinSeg_rcpp_binseg_update, 7},
+    {"_BinSeg_rcpp_binseg_multi", (DL_FUNC) &_BinSeg_rcpp_binseg_multi, 11},
+    {"_BinSeg_rcpp_binseg_file", (DL_FUNC) &_BinSeg_rcpp_binseg_file, 18},
+    {"_BinSeg_rcpp_binseg_batch", (DL_FUNC) &_BinSeg_rcpp_binseg_batch, 10},
+    {"_BinSeg_rcpp_binseg_cv", (DL_FUNC) &_BinSeg_rcpp_binseg_cv, 9},
+    {"_BinSeg_rcpp_stream_create", (DL_FUNC) &_BinSeg_rcpp_stream_create, 8},
+    {"_BinSeg_rcpp_stream_append", (DL_FUNC) &_BinSeg_rcpp_stream_append, 2},
+    {"_BinSeg_rcpp_stream_cache_size", (DL_FUNC) &_BinSeg_rcpp_stream_cache_size, 1},
     {"_BinSeg_distributions_info", (DL_FUNC) &_BinSeg_distributions_info, 0},
     {"_BinSeg_algorithms_info", (DL_FUNC) &_BinSeg_algorithms_info, 0},
     {NULL, NULL, 0}
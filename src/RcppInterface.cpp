@@ -1,92 +1,389 @@
 
 #include <Rcpp.h>
 #include <R.h>
-#include "Distributions.cpp"
-
-// The initialization of the static variables was originally planned to be inline.
-// See https://github.com/diego-urgell/BinSeg/releases/tag/std_rcpp17 for more information about this.
-// This solution is temporary, and will be changed as soon as the external bug is fixed.
-
-std::vector<std::string> mean_norm::param_names = {"before_mean", "after_mean"};
-std::vector<std::string> var_norm::param_names = {"before_var", "after_var"};
-std::vector<std::string> meanvar_norm::param_names = {"before_mean", "after_mean", "before_var", "after_var"};
-std::vector<std::string> negbin::param_names = {"before_prob", "after_prob"};
-std::vector<std::string> poisson::param_names = {"before_rate", "after_rate"};
-std::vector<std::string> exponential::param_names = {"before_rate", "after_rate"};
-
-std::string mean_norm::factoryName = "mean_norm";
-std::string var_norm::factoryName = "var_norm";
-std::string meanvar_norm::factoryName = "meanvar_norm";
-std::string negbin::factoryName = "negbin";
-std::string poisson::factoryName = "poisson";
-std::string exponential::factoryName = "exponential";
-
-std::string mean_norm::description = "Normal distribution with change in Mean and constant Variance";
-std::string var_norm::description = "Normal Distribution with change in Variance and constant Mean";
-std::string meanvar_norm::description = "Normal distribution with change in both mean and variance";
-std::string negbin::description = "Negative Binomial distribution with change in Probability of Success";
-std::string poisson::description = "Poisson distribution with change in Rate";
-std::string exponential::description = "Exponential distribution with change in Rate";
-
-std::vector<std::string> BS::param_names = {"cpts_index", "cpts", "invalidates_index", "invalidates_after", "cost"};
-
-std::string BS::factoryName = "BS";
-
-std::string BS::description = "Regular Binary Segmentation";
-
-template<>
-std::map<std::string, std::shared_ptr<Distribution>(*)()> GenericFactory<Distribution>::regSpecs =
-        std::map<std::string, std::shared_ptr<Distribution>(*)()>();
-
-template<>
-std::map<std::string, std::shared_ptr<Algorithm>(*)()> GenericFactory<Algorithm>::regSpecs =
-        std::map<std::string, std::shared_ptr<Algorithm>(*)()>();
-
-template<>
-std::map<std::string, std::string> GenericFactory<Algorithm>::regDescs = std::map<std::string, std::string>();
-
-template<>
-std::map<std::string, std::string> GenericFactory<Distribution>::regDescs = std::map<std::string, std::string>();
-
-template<>
-bool Registration<mean_norm, Distribution, DistributionFactory>::is_registered =
-        DistributionFactory::Register(mean_norm::factoryName, mean_norm::description, mean_norm::createMethod);
-template<>
-bool Registration<var_norm, Distribution, DistributionFactory>::is_registered =
-        DistributionFactory::Register(var_norm::factoryName, var_norm::description, var_norm::createMethod);
-template<>
-bool Registration<meanvar_norm, Distribution, DistributionFactory>::is_registered =
-        DistributionFactory::Register(meanvar_norm::factoryName, meanvar_norm::description, meanvar_norm::createMethod);
-template<>
-bool Registration<negbin, Distribution, DistributionFactory>::is_registered =
-        DistributionFactory::Register(negbin::factoryName, negbin::description, negbin::createMethod);
-template<>
-bool Registration<poisson, Distribution, DistributionFactory>::is_registered =
-        DistributionFactory::Register(poisson::factoryName, poisson::description, poisson::createMethod);
-template<>
-bool Registration<exponential, Distribution, DistributionFactory>::is_registered =
-        DistributionFactory::Register(exponential::factoryName, exponential::description, exponential::createMethod);
-
-template<>
-bool Registration<BS, Algorithm, AlgorithmFactory>::is_registered =
-        AlgorithmFactory::Register(BS::factoryName, BS::description, BS::createMethod);
+#include <atomic>
+#include <climits>
+#include <chrono>
+#include "Distributions.h"
+#include "Algorithms.h"
+#include "SharedStatistics.h"
+#include "StreamSegmenter.h"
+#include "ResumableModel.h"
+#include "CrossValidation.h"
+
+// Allocates the columns of a models summary, with the given names and number of rows, and stores a pointer to the values
+// of each one. They are returned as a list, which R turns into a data.table by reference (see setDT), so that the
+// columns are filled only once and never copied again.
+Rcpp::List summary_columns(size_t numRows, const std::vector<std::string> &names, std::vector<double *> &columns){
+    Rcpp::List summary(names.size());
+    columns.resize(names.size());
+    for (size_t j = 0; j < names.size(); j++){
+        Rcpp::NumericVector column(numRows);
+        columns[j] = column.begin();
+        summary[j] = column;
+    }
+    summary.names() = Rcpp::wrap(names);
+    return summary;
+}
+
+
+// Copies the models computed by an algorithm into the columns of a models summary, with NA as the undefined values.
+Rcpp::List models_summary(ModelTable &models, const std::vector<std::string> &names){
+    std::vector<double *> columns;
+    Rcpp::List summary = summary_columns(models.getNumRows(), names, columns);
+    for (int j = 0; j < models.getNumCols(); j++) models.copyColumn(j, columns[j], NA_REAL);
+    return summary;
+}
+
+// Same as models_summary, with the performance counters of the run as the "counters" attribute if they were enabled (see
+// RunCounters), as a named numeric vector. If the run was interrupted, the "interrupted" attribute is TRUE.
+Rcpp::List run_summary(Algorithm &algo){
+    Rcpp::List summary = models_summary(algo.models, algo.getParamNames());
+    if (algo.counters != nullptr){
+        Rcpp::NumericVector counters = Rcpp::wrap(algo.counters -> values());
+        counters.names() = Rcpp::wrap(RunCounters::names());
+        summary.attr("counters") = counters;
+    }
+    if (algo.isInterrupted()) summary.attr("interrupted") = true;
+    return summary;
+}
+
+// Runs the algorithm, checking for user interrupts between its iterations (see Algorithm::setCheckpoint). The checks,
+// and the calls to the progress function (unless it is NULL) with the number of changepoints found so far and numCpts,
+// are done at most every 100 milliseconds, and the progress is reported once more at the end. If the user interrupts
+// the run, it stops and the models found until then are kept. The checkpoints are only called on this thread while no
+// segment is being scanned, so the threads of the pool are idle, and they are joined when the algorithm is destroyed.
+void run_checked(Algorithm &algo, SEXP progress, int numCpts){
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point last = Clock::now();
+    std::function<void(int)> report;
+    if (progress != R_NilValue){
+        Rcpp::Function callback(progress);
+        report = [callback, numCpts](int numFound){ callback(numFound, numCpts); };
+    }
+    algo.setCheckpoint([&last, &report](int numFound){
+        if (Clock::now() - last < std::chrono::milliseconds(100)) return false;
+        last = Clock::now();
+        if (report) report(numFound);
+        try {
+            Rcpp::checkUserInterrupt();
+        } catch (Rcpp::internal::InterruptedException &) {
+            return true;
+        }
+        return false;
+    });
+    algo.run();
+    algo.setCheckpoint(nullptr);
+    if (report && !algo.isInterrupted()) report(algo.models.getNumRows() - 1);
+}
+
+// Same as run_summary, and if resumable is true, the state of the algorithm is kept as the "state" attribute, so that
+// the models can be updated later with rcpp_binseg_update (see ResumableModel).
+Rcpp::List resumable_summary(std::shared_ptr<Algorithm> algo, bool resumable){
+    Rcpp::List summary = run_summary(*algo);
+    if (resumable) summary.attr("state") = Rcpp::XPtr<ResumableModel>(new ResumableModel(algo), true);
+    return summary;
+}
 
 
 // [[Rcpp::export]]
-Rcpp::NumericMatrix rcpp_binseg(Rcpp::NumericVector data, Rcpp::String algorithm, Rcpp::String distribution, int numCpts, int minSegLen){
+Rcpp::List rcpp_binseg(Rcpp::NumericVector data, Rcpp::String algorithm, Rcpp::String distribution, int numCpts,
+                       int minSegLen, int numThreads = 1, int parallelThreshold = 50000, int numIntervals = 5000,
+                       int seed = 0, double penalty = R_NegInf, bool stableSums = true,
+                       std::string storage = "double", bool runLength = false, bool pruned = false,
+                       bool counters = false, SEXP progress = R_NilValue, int searchStride = 1,
+                       int searchWindow = 0, bool resumable = false){
 
     std::shared_ptr<Distribution> dist = DistributionFactory::Create(distribution);
     std::shared_ptr<Algorithm> algo = AlgorithmFactory::Create(algorithm);
 
-    Rcpp::NumericMatrix params_mat = Rcpp::NumericMatrix(numCpts + 1, dist -> getParamCount() + 5);
+    try {
+        dist -> setCumsum();
+        if (stableSums) dist -> useStableSums();
+        dist -> summaryStatistics -> setStorage(PrefixSums::parseType(storage));
+        if (runLength) dist -> summaryStatistics -> useRuns();
+        if (pruned) dist -> summaryStatistics -> useBounds();
+    } catch (const char * message) {
+        Rcpp::stop(message);
+    }
+    if (counters) algo -> setCounters(std::make_shared<RunCounters>());
+    algo -> init(&data[0], data.size(), numCpts, dist, minSegLen);
+    algo -> setParallelism(numThreads, parallelThreshold);
+    algo -> setApproximate(searchStride, searchWindow);
+    algo -> setRandomIntervals(numIntervals, seed);
+    algo -> setPenalty(penalty);
+    run_checked(*algo, progress, numCpts);
+
+    return resumable_summary(algo, resumable);
+}
+
+
+// [[Rcpp::export]]
+SEXP rcpp_stats_create(bool stableSums = true, std::string storage = "double", bool runLength = false,
+                       bool pruned = false){
+    StorageType type = DOUBLE_STORAGE;
+    try {
+        type = PrefixSums::parseType(storage);
+    } catch (const char * message) {
+        Rcpp::stop(message);
+    }
+    SharedStatistics * stats = new SharedStatistics(stableSums, type, runLength, pruned);
+    return Rcpp::XPtr<SharedStatistics>(stats, true);
+}
+
+
+// Same as rcpp_binseg, but the summary statistics are taken from (or added to) the shared statistics of the data.
+// [[Rcpp::export]]
+Rcpp::List rcpp_binseg_shared(SEXP stats, Rcpp::NumericVector data, Rcpp::String algorithm, Rcpp::String distribution,
+                              int numCpts, int minSegLen, int numThreads = 1, int parallelThreshold = 50000,
+                              int numIntervals = 5000, int seed = 0, double penalty = R_NegInf,
+                              bool counters = false, SEXP progress = R_NilValue, int searchStride = 1,
+                              int searchWindow = 0, bool resumable = false){
+    Rcpp::XPtr<SharedStatistics> shared(stats);
+    std::shared_ptr<Distribution> dist = DistributionFactory::Create(distribution);
+    std::shared_ptr<Algorithm> algo = AlgorithmFactory::Create(algorithm);
+
+    try {
+        shared -> attach(dist.get(), data.begin(), data.size());
+    } catch (const char * message) {
+        Rcpp::stop(message);
+    }
+    if (counters) algo -> setCounters(std::make_shared<RunCounters>());
+    algo -> prepare(data.size(), numCpts, dist, minSegLen);
+    algo -> setParallelism(numThreads, parallelThreshold);
+    algo -> setApproximate(searchStride, searchWindow);
+    algo -> setRandomIntervals(numIntervals, seed);
+    algo -> setPenalty(penalty);
+    run_checked(*algo, progress, numCpts);
+
+    return resumable_summary(algo, resumable);
+}
+
+
+// Updates the models kept by rcpp_binseg with another number of changepoints or minimum segment length (see
+// ResumableModel). The summary has every model that is kept, which can be more than numCpts, and its "penalized"
+// attribute is true if the analysis stops with a penalty, so that fewer changepoints than numCpts are expected.
+// [[Rcpp::export]]
+Rcpp::List rcpp_binseg_update(SEXP state, int numCpts, int minSegLen, int numThreads = 1,
+                              int parallelThreshold = 50000, bool counters = false, SEXP progress = R_NilValue){
+    Rcpp::XPtr<ResumableModel> model(state);
+    if (model.get() == nullptr) Rcpp::stop("The state of the models is not available, compute them with BinSegModel");
+    Algorithm &algo = model -> getAlgorithm();
+
+    algo.setCounters(counters ? std::make_shared<RunCounters>() : nullptr);
+    model -> update(numCpts, minSegLen);
+    algo.setParallelism(numThreads, parallelThreshold);
+    run_checked(algo, progress, numCpts);
+    Rcpp::List summary = run_summary(algo);
+    if (algo.isPenalized()) summary.attr("penalized") = true;
+    model -> release();
+
+    return summary;
+}
+
+
+// Same as rcpp_binseg, for a multivariate distribution. The data is a matrix with one column per channel.
+// [[Rcpp::export]]
+Rcpp::List rcpp_binseg_multi(Rcpp::NumericMatrix data, Rcpp::String algorithm, Rcpp::String distribution, int numCpts,
+                             int minSegLen, int numThreads = 1, int parallelThreshold = 50000, int numIntervals = 5000,
+                             int seed = 0, double penalty = R_NegInf, bool stableSums = true){
+
+    std::shared_ptr<Distribution> dist = DistributionFactory::Create(distribution);
+    std::shared_ptr<Algorithm> algo = AlgorithmFactory::Create(algorithm);
 
     dist -> setCumsum();
-    algo -> init(&data[0], data.size(), numCpts, dist, minSegLen, &params_mat[0]);
-    algo -> binseg();
+    try {
+        dist -> setChannels(data.ncol());
+    } catch (const char * message) {
+        Rcpp::stop(message);
+    }
+    if (stableSums) dist -> useStableSums();
+    algo -> init(data.begin(), data.nrow(), numCpts, dist, minSegLen);
+    algo -> setParallelism(numThreads, parallelThreshold);
+    algo -> setRandomIntervals(numIntervals, seed);
+    algo -> setPenalty(penalty);
+    run_checked(*algo, R_NilValue, numCpts);
 
-    Rcpp::colnames(params_mat) = Rcpp::wrap(algo -> getParamNames());
+    return run_summary(*algo);
+}
 
-    return params_mat;
+
+// Appends the values of a mapped binary file to the distribution in chunks.
+template<class T>
+void append_file(const MappedFile &file, Distribution * dist, int length){
+    const int chunkSize = 1 << 16;
+    std::vector<double> chunk(chunkSize);
+    for (int first = 0; first < length; first += chunkSize){
+        int count = std::min(chunkSize, length - first);
+        file.decode<T>(first, count, chunk.data());
+        for (int i = 0; i < count; i++) if (std::isnan(chunk[i])) throw "NA is not allowed";
+        dist -> appendData(chunk.data(), count);
+    }
+}
+
+
+// [[Rcpp::export]]
+Rcpp::List rcpp_binseg_file(std::string path, std::string type, std::string scratch, Rcpp::String algorithm,
+                            Rcpp::String distribution, int numCpts, int minSegLen, int numThreads = 1,
+                            int parallelThreshold = 50000, int numIntervals = 5000, int seed = 0,
+                            double penalty = R_NegInf, bool stableSums = true, std::string storage = "double",
+                            bool runLength = false, bool pruned = false, int searchStride = 1,
+                            int searchWindow = 0){
+
+    std::shared_ptr<Distribution> dist = DistributionFactory::Create(distribution);
+    std::shared_ptr<Algorithm> algo = AlgorithmFactory::Create(algorithm);
+    size_t valueSize = type == "float" ? sizeof(float) : sizeof(double);
+    int length;
+
+    try {
+        MappedFile file(path);
+        if (file.size() % valueSize != 0) Rcpp::stop("The size of the file is not a multiple of the size of the values");
+        if (file.size() / valueSize > (size_t) INT_MAX) Rcpp::stop("The file has too many values");
+        length = file.size() / valueSize;
+        if (length < 1) Rcpp::stop("At least one datapoint is needed");
+        dist -> setCumsum();
+        if (stableSums) dist -> useStableSums();
+        dist -> summaryStatistics -> setStorage(PrefixSums::parseType(storage));
+        if (runLength) dist -> summaryStatistics -> useRuns();
+        if (pruned) dist -> summaryStatistics -> useBounds();
+        if (!scratch.empty()) dist -> summaryStatistics -> useScratch(scratch);
+        dist -> summaryStatistics -> reserve(length);
+        if (type == "float") append_file<float>(file, dist.get(), length);
+        else append_file<double>(file, dist.get(), length);
+    } catch (const char * message) {
+        Rcpp::stop(message);
+    }
+
+    algo -> prepare(length, numCpts, dist, minSegLen);
+    algo -> setParallelism(numThreads, parallelThreshold);
+    algo -> setApproximate(searchStride, searchWindow);
+    algo -> setRandomIntervals(numIntervals, seed);
+    algo -> setPenalty(penalty);
+    run_checked(*algo, R_NilValue, numCpts);
+
+    return run_summary(*algo);
+}
+
+
+// [[Rcpp::export]]
+Rcpp::List rcpp_binseg_batch(Rcpp::NumericVector data, Rcpp::IntegerVector offsets, Rcpp::String algorithm,
+                             Rcpp::String distribution, int numCpts, int minSegLen, int numThreads = 1,
+                             int numIntervals = 5000, int seed = 0, bool stableSums = true){
+
+    int numSeries = offsets.size() - 1;
+    int numWorkers = std::max(1, std::min(numThreads, numSeries));
+
+    // Every worker reuses its own distribution (and therefore its Cumsum buffers) and algorithm for all its series.
+    std::vector<std::shared_ptr<Distribution>> dists(numWorkers);
+    std::vector<std::shared_ptr<Algorithm>> algos(numWorkers);
+    for (int w = 0; w < numWorkers; w++){
+        dists[w] = DistributionFactory::Create(distribution);
+        dists[w] -> setCumsum();
+        if (stableSums) dists[w] -> useStableSums();
+        algos[w] = AlgorithmFactory::Create(algorithm);
+        algos[w] -> dist = dists[w];
+        algos[w] -> setRandomIntervals(numIntervals, seed);
+    }
+    std::vector<std::string> names = algos[0] -> getParamNames();
+    names.insert(names.begin(), "series");
+
+    // No R API can be used by the workers, so only raw pointers are shared with them.
+    const double * values = data.begin();
+    const int * bounds = offsets.begin();
+    std::vector<ModelTable> results(numSeries);
+    // The error of each worker, raised with Rcpp::stop on this thread once every worker is done.
+    std::vector<const char *> errors(numWorkers, nullptr);
+
+    std::atomic<int> next(0);
+    ThreadPool pool(numWorkers);
+    pool.parallelFor(numWorkers, [&](int w){
+        try {
+            for (int k = next++; k < numSeries; k = next++){
+                int start = bounds[k], length = bounds[k + 1] - bounds[k];
+                if (length < 1) continue;
+                algos[w] -> init(values + start, length, numCpts, dists[w], minSegLen);
+                algos[w] -> run();
+                results[k] = algos[w] -> models;
+            }
+        } catch (const char * message) {
+            errors[w] = message;
+            next = numSeries; // The other workers stop after their current series
+        }
+    });
+    for (const char * message: errors)
+        if (message != nullptr) Rcpp::stop(message);
+
+    size_t numRows = 0;
+    for (ModelTable &models: results) numRows += models.getNumRows();
+    std::vector<double *> columns;
+    Rcpp::List summary = summary_columns(numRows, names, columns);
+    size_t row = 0;
+    for (int k = 0; k < numSeries; k++){
+        int count = results[k].getNumRows();
+        std::fill(columns[0] + row, columns[0] + row + count, k + 1);
+        for (int j = 0; j < results[k].getNumCols(); j++) results[k].copyColumn(j, columns[j + 1] + row, NA_REAL);
+        row += count;
+    }
+
+    return summary;
+}
+
+
+// [[Rcpp::export]]
+Rcpp::List rcpp_binseg_cv(Rcpp::NumericVector data, Rcpp::String algorithm, Rcpp::String distribution, int numCpts,
+                          int minSegLen, int numThreads = 2, int numIntervals = 5000, int seed = 0,
+                          bool stableSums = true){
+
+    CrossValidation cv(algorithm, distribution, stableSums);
+    cv.setRandomIntervals(numIntervals, seed);
+    try {
+        cv.run(data.begin(), data.size(), numCpts, minSegLen, numThreads);
+    } catch (const char * message) {
+        Rcpp::stop(message);
+    }
+
+    std::vector<double *> columns;
+    Rcpp::List summary = summary_columns(cv.getNumModels(), {"num_cpts", "cost", "cost_odd", "cost_even"}, columns);
+    for (int k = 0; k < cv.getNumModels(); k++){
+        columns[0][k] = k;
+        columns[1][k] = cv.getHeldOutCost(0, k) + cv.getHeldOutCost(1, k);
+        columns[2][k] = cv.getHeldOutCost(0, k);
+        columns[3][k] = cv.getHeldOutCost(1, k);
+    }
+    summary.attr("selected") = cv.getSelected();
+    return summary;
+}
+
+
+// [[Rcpp::export]]
+SEXP rcpp_stream_create(Rcpp::String algorithm, Rcpp::String distribution, int numCpts, int minSegLen,
+                        int numIntervals = 5000, int seed = 0, bool stableSums = true, int window = 0){
+    StreamSegmenter * stream = new StreamSegmenter(algorithm, distribution, numCpts, minSegLen, stableSums);
+    stream -> setRandomIntervals(numIntervals, seed);
+    stream -> setWindow(window);
+    return Rcpp::XPtr<StreamSegmenter>(stream, true);
+}
+
+
+// [[Rcpp::export]]
+Rcpp::List rcpp_stream_append(SEXP stream, Rcpp::NumericVector data){
+    Rcpp::XPtr<StreamSegmenter> segmenter(stream);
+
+    try {
+        segmenter -> append(data.begin(), data.size());
+        segmenter -> segment();
+    } catch (const char * message) {
+        Rcpp::stop(message);
+    }
+
+    return models_summary(segmenter -> getModels(), segmenter -> getParamNames());
+}
+
+
+// [[Rcpp::export]]
+int rcpp_stream_cache_size(SEXP stream){
+    Rcpp::XPtr<StreamSegmenter> segmenter(stream);
+    return segmenter -> getCacheSize();
 }
 
 
@@ -0,0 +1,108 @@
+#include "Distributions.h"
+#include "Algorithms.h"
+#include "CrossValidation.h"
+
+// The initialization of the static variables was originally planned to be inline.
+// See https://github.com/diego-urgell/BinSeg/releases/tag/std_rcpp17 for more information about this.
+// This solution is temporary, and will be changed as soon as the external bug is fixed.
+
+std::vector<std::string> mean_norm::param_names = {"before_mean", "after_mean"};
+std::vector<std::string> var_norm::param_names = {"before_var", "after_var"};
+std::vector<std::string> meanvar_norm::param_names = {"before_mean", "after_mean", "before_var", "after_var"};
+std::vector<std::string> negbin::param_names = {"before_prob", "after_prob"};
+std::vector<std::string> poisson::param_names = {"before_rate", "after_rate"};
+std::vector<std::string> exponential::param_names = {"before_rate", "after_rate"};
+std::vector<std::string> multi_mean_norm::param_names = {"before_mean", "after_mean"};
+std::vector<std::string> multi_meanvar_norm::param_names = {"before_mean", "after_mean", "before_var", "after_var"};
+std::vector<std::string> multi_meancov_norm::param_names = {"before_mean", "after_mean", "before_var", "after_var"};
+
+std::string mean_norm::factoryName = "mean_norm";
+std::string var_norm::factoryName = "var_norm";
+std::string meanvar_norm::factoryName = "meanvar_norm";
+std::string negbin::factoryName = "negbin";
+std::string poisson::factoryName = "poisson";
+std::string exponential::factoryName = "exponential";
+std::string multi_mean_norm::factoryName = "multi_mean_norm";
+std::string multi_meanvar_norm::factoryName = "multi_meanvar_norm";
+std::string multi_meancov_norm::factoryName = "multi_meancov_norm";
+
+std::string mean_norm::description = "Normal distribution with change in Mean and constant Variance";
+std::string var_norm::description = "Normal Distribution with change in Variance and constant Mean";
+std::string meanvar_norm::description = "Normal distribution with change in both mean and variance";
+std::string negbin::description = "Negative Binomial distribution with change in Probability of Success";
+std::string poisson::description = "Poisson distribution with change in Rate";
+std::string exponential::description = "Exponential distribution with change in Rate";
+std::string multi_mean_norm::description = "Multivariate Normal distribution with change in Mean of every channel";
+std::string multi_meanvar_norm::description =
+        "Multivariate Normal distribution with independent channels and change in Mean and Variance";
+std::string multi_meancov_norm::description = "Multivariate Normal distribution with change in Mean and Covariance";
+
+std::vector<std::string> BS::param_names = {"cpts_index", "cpts", "invalidates_index", "invalidates_after", "cost"};
+std::vector<std::string> SeedBS::param_names = BS::param_names;
+std::vector<std::string> WildBS::param_names = BS::param_names;
+
+std::string BS::factoryName = "BS";
+std::string SeedBS::factoryName = "SeedBS";
+std::string WildBS::factoryName = "WildBS";
+
+std::string BS::description = "Regular Binary Segmentation";
+std::string SeedBS::description = "Seeded Binary Segmentation with deterministic multiscale intervals";
+std::string WildBS::description = "Wild Binary Segmentation with random intervals";
+
+const int Algorithm::initialCapacity;
+const int CrossValidation::numFolds;
+
+template<>
+std::map<std::string, std::shared_ptr<Distribution>(*)()> GenericFactory<Distribution>::regSpecs =
+        std::map<std::string, std::shared_ptr<Distribution>(*)()>();
+
+template<>
+std::map<std::string, std::shared_ptr<Algorithm>(*)()> GenericFactory<Algorithm>::regSpecs =
+        std::map<std::string, std::shared_ptr<Algorithm>(*)()>();
+
+template<>
+std::map<std::string, std::string> GenericFactory<Algorithm>::regDescs = std::map<std::string, std::string>();
+
+template<>
+std::map<std::string, std::string> GenericFactory<Distribution>::regDescs = std::map<std::string, std::string>();
+
+template<>
+bool Registration<mean_norm, Distribution, DistributionFactory>::is_registered =
+        DistributionFactory::Register(mean_norm::factoryName, mean_norm::description, mean_norm::createMethod);
+template<>
+bool Registration<var_norm, Distribution, DistributionFactory>::is_registered =
+        DistributionFactory::Register(var_norm::factoryName, var_norm::description, var_norm::createMethod);
+template<>
+bool Registration<meanvar_norm, Distribution, DistributionFactory>::is_registered =
+        DistributionFactory::Register(meanvar_norm::factoryName, meanvar_norm::description, meanvar_norm::createMethod);
+template<>
+bool Registration<negbin, Distribution, DistributionFactory>::is_registered =
+        DistributionFactory::Register(negbin::factoryName, negbin::description, negbin::createMethod);
+template<>
+bool Registration<poisson, Distribution, DistributionFactory>::is_registered =
+        DistributionFactory::Register(poisson::factoryName, poisson::description, poisson::createMethod);
+template<>
+bool Registration<exponential, Distribution, DistributionFactory>::is_registered =
+        DistributionFactory::Register(exponential::factoryName, exponential::description, exponential::createMethod);
+template<>
+bool Registration<multi_mean_norm, Distribution, DistributionFactory>::is_registered =
+        DistributionFactory::Register(multi_mean_norm::factoryName, multi_mean_norm::description,
+                                      multi_mean_norm::createMethod);
+template<>
+bool Registration<multi_meanvar_norm, Distribution, DistributionFactory>::is_registered =
+        DistributionFactory::Register(multi_meanvar_norm::factoryName, multi_meanvar_norm::description,
+                                      multi_meanvar_norm::createMethod);
+template<>
+bool Registration<multi_meancov_norm, Distribution, DistributionFactory>::is_registered =
+        DistributionFactory::Register(multi_meancov_norm::factoryName, multi_meancov_norm::description,
+                                      multi_meancov_norm::createMethod);
+
+template<>
+bool Registration<BS, Algorithm, AlgorithmFactory>::is_registered =
+        AlgorithmFactory::Register(BS::factoryName, BS::description, BS::createMethod);
+template<>
+bool Registration<SeedBS, Algorithm, AlgorithmFactory>::is_registered =
+        AlgorithmFactory::Register(SeedBS::factoryName, SeedBS::description, SeedBS::createMethod);
+template<>
+bool Registration<WildBS, Algorithm, AlgorithmFactory>::is_registered =
+        AlgorithmFactory::Register(WildBS::factoryName, WildBS::description, WildBS::createMethod);
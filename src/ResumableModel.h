@@ -0,0 +1,57 @@
+#ifndef BINSEG_RESUMABLE_MODEL_H
+#define BINSEG_RESUMABLE_MODEL_H
+
+#include "AlgorithmInterface.h"
+
+/**
+ * The state of a finished analysis, so that it can be updated without starting over. It keeps the algorithm, with its
+ * distribution and summary statistics, its candidate segments and its models. Asking for more changepoints continues
+ * the search from the last model found if the algorithm is resumable (see Algorithm::resume), and otherwise, or if the
+ * minimum segment length changes, the algorithm runs again over the same summary statistics. The thread pool is not
+ * kept, since its threads would stay alive as long as the state.
+ */
+class ResumableModel {
+
+private:
+
+    std::shared_ptr<Algorithm> algo;
+
+public:
+
+    /**
+     * @param algo An algorithm that has already run.
+     */
+    explicit ResumableModel(std::shared_ptr<Algorithm> algo){
+        this -> algo = algo;
+        this -> release();
+    }
+
+    Algorithm & getAlgorithm(){
+        return *this -> algo;
+    }
+
+    /**
+     * Prepares the algorithm to compute the models with the given number of changepoints and minimum segment length.
+     * The models table of the next run starts with the models that are kept, so it can have more changepoints than
+     * requested if a previous run found them.
+     * @param numCpts The number of changepoints.
+     * @param minSegLen The minimum segment length.
+     */
+    void update(int numCpts, int minSegLen){
+        Algorithm &algo = *this -> algo;
+        if (minSegLen == algo.minSegLen && algo.isResumable())
+            algo.resume(std::max(numCpts, algo.numCpts));
+        else
+            algo.prepare(algo.length, numCpts, algo.dist, minSegLen);
+    }
+
+    /**
+     * Joins the threads of the pool, if any, once a run is over.
+     */
+    void release(){
+        this -> algo -> setParallelism(1, this -> algo -> dist -> parallelThreshold);
+        this -> algo -> setCheckpoint(nullptr);
+    }
+};
+
+#endif // BINSEG_RESUMABLE_MODEL_H
@@ -0,0 +1,43 @@
+#ifndef BINSEG_RUN_COUNTERS_H
+#define BINSEG_RUN_COUNTERS_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/**
+ * Performance counters of a single run of an algorithm, to find out where the time goes. They are optional: the
+ * distribution, the candidates queue and the algorithm only hold a pointer to them, which is null unless they are
+ * requested, and they are updated once per scan or queue operation rather than once per candidate split. The counters
+ * that are updated by the scans are atomic, since the scans may run concurrently (see ThreadPool).
+ */
+struct RunCounters {
+
+    double initSeconds = 0; // Time spent computing the summary statistics of the data (see Cumsum::init)
+    std::atomic<long long> costEvaluations{0}; // Costs of the halves of the candidate splits scanned by the segments
+    std::atomic<long long> infiniteAborts{0}; // Scans abandoned because a candidate split had an infinite cost
+    long long queueOperations = 0; // Pushes and pops of the candidates queue
+    long long peakCandidates = 0; // Largest number of segments in the candidates queue at once
+    double bytes = 0; // Memory held by the summary statistics, the candidates and the models at the end of the run
+
+    /**
+     * Adds the time elapsed since begin to the time spent computing the summary statistics.
+     */
+    void addInitTime(std::chrono::steady_clock::time_point begin){
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        this -> initSeconds += elapsed.count();
+    }
+
+    static std::vector<std::string> names(){
+        return {"init_seconds", "cost_evaluations", "infinite_aborts", "queue_operations", "peak_candidates",
+                "bytes"};
+    }
+
+    std::vector<double> values(){
+        return {this -> initSeconds, (double) this -> costEvaluations, (double) this -> infiniteAborts,
+                (double) this -> queueOperations, (double) this -> peakCandidates, this -> bytes};
+    }
+};
+
+#endif // BINSEG_RUN_COUNTERS_H
@@ -0,0 +1,63 @@
+//
+// Created by Diego Urgell on 16/06/21.
+//
+
+#ifndef BINSEG_SEGMENT_H
+#define BINSEG_SEGMENT_H
+
+#include "DistributionInterface.h"
+
+/**
+ * This class represents a segment that is to be partitioned. It finds the optimal partition in terms of the cost decrease
+ * produced by the two newly created segments, and stores the best_decrease and the changepoint.
+ */
+class Segment {
+
+public:
+
+    int start, mid, end, minSegLen;
+    double bestDecrease, costNoSplit;
+    int invalidatesIndex, invalidatesAfter;
+    Distribution * dist; // In order to calculate the costs. It is owned by the Algorithm.
+
+public:
+
+    /**
+     * A segment initialization requires the start and end indexes, as well as the distribution that contains the methods
+     * to compute the cost of a partition. The optimal partition is not computed here, so that the scans of several
+     * segments can be run concurrently. Call optimalPartition before using mid or bestDecrease.
+     * @param start inclusive
+     * @param end inclusive
+     * @param dist A Distribution pointer to get the cost of partition. It must outlive the segment.
+     */
+    Segment(int start, int end, Distribution * dist, int minSegLen, int invalidatesAfter, int invalidatesIndex){
+        this -> start = start;
+        this -> end = end;
+        this -> mid = 0;
+        this -> dist = dist;
+        this -> minSegLen = minSegLen;
+        this -> bestDecrease = 0;
+        this -> costNoSplit = this -> dist -> costFunction(start, end); // The cost of the whole segment
+        this -> invalidatesAfter = invalidatesAfter;
+        this -> invalidatesIndex = invalidatesIndex;
+    }
+
+    /**
+     * In this method, the changepoint whose segmentation produces the best decrease in cost is identified. The scan over
+     * every possible changepoint is delegated to Distribution::bestSplit, which computes the cost of the two segments
+     * for each candidate, or to Distribution::approximateSplit if the distribution has a search stride. At the end, it
+     * computes the bestDecrease.
+     */
+    void optimalPartition(){
+        int first = this -> start + this -> minSegLen, last = this -> end - this -> minSegLen;
+        double bestSplitCost = this -> dist -> searchStride > 1 ?
+                               this -> dist -> approximateSplit(this -> start, this -> end, first, last, this -> mid) :
+                               this -> dist -> bestSplit(this -> start, this -> end, first, last, this -> mid);
+        this -> bestDecrease = this -> costNoSplit - bestSplitCost;
+        if (bestSplitCost == INFINITY && this -> dist -> counters != nullptr)
+            this -> dist -> counters -> infiniteAborts++;
+    }
+
+};
+
+#endif // BINSEG_SEGMENT_H
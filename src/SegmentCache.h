@@ -0,0 +1,103 @@
+#ifndef BINSEG_SEGMENT_CACHE_H
+#define BINSEG_SEGMENT_CACHE_H
+
+#include <map>
+#include <climits>
+#include "CandidateQueue.h"
+
+/**
+ * Stores the optimal partition of the segments that have already been evaluated, so that they are not scanned again
+ * when the same segment is created in a later run of the algorithm over the same data (i.e. after new observations are
+ * appended to a stream). The entries are ordered by the end of the segment, so that the ones that reach the end of the
+ * data can be discarded efficiently. The segments are stored with the indices of the whole stream, which are the ones of
+ * the data plus an offset, so that they are still found after the oldest observations are removed (see slide). Only
+ * the segments of the last run are kept (see retain), so the size of the cache does not grow with the stream.
+ */
+class SegmentCache {
+
+private:
+
+    struct Split {
+        int mid;
+        bool found; // False if the segment can not be split, in which case mid is 0 and is not shifted
+        double bestDecrease;
+    };
+
+    std::map<std::pair<int, int>, Split> splits; // Keyed by (end, start)
+    int offset = 0; // The number of observations removed from the start of the data
+
+public:
+
+    SegmentCache() = default;
+
+    /**
+     * Looks for the segment in the cache and, if it is found, copies its optimal partition into it.
+     * @param segment The segment to look for.
+     * @return true if the segment was found.
+     */
+    bool lookup(Segment &segment){
+        std::map<std::pair<int, int>, Split>::iterator it =
+            this -> splits.find(std::make_pair(segment.end + this -> offset, segment.start + this -> offset));
+        if (it == this -> splits.end()) return false;
+        segment.mid = it -> second.found ? it -> second.mid - this -> offset : 0;
+        segment.bestDecrease = it -> second.bestDecrease;
+        return true;
+    }
+
+    /**
+     * Stores the optimal partition of an evaluated segment.
+     */
+    void store(const Segment &segment){
+        bool found = segment.mid != 0;
+        Split split = {found ? segment.mid + this -> offset : 0, found, segment.bestDecrease};
+        this -> splits[std::make_pair(segment.end + this -> offset, segment.start + this -> offset)] = split;
+    }
+
+    /**
+     * Discards every segment that ends at or after the given index.
+     * @param index The first discarded end.
+     */
+    void discardFrom(int index){
+        std::pair<int, int> from = std::make_pair(index + this -> offset, INT_MIN);
+        this -> splits.erase(this -> splits.lower_bound(from), this -> splits.end());
+    }
+
+    /**
+     * Shifts the indices after the given number of observations are removed from the start of the data, discarding
+     * the segments that started before the new first observation.
+     * @param count The number of removed observations.
+     */
+    void slide(int count){
+        this -> offset += count;
+        for (auto it = this -> splits.begin(); it != this -> splits.end();){
+            if (it -> first.second < this -> offset) it = this -> splits.erase(it);
+            else it++;
+        }
+    }
+
+    /**
+     * Discards every segment that is not in the candidates pool of the last run, that is, the ones that are not
+     * segments of its models or candidates for them. The segments of older runs are unlikely to be created again.
+     * @param candidates The candidates of the last run.
+     */
+    void retain(CandidateQueue &candidates){
+        std::map<std::pair<int, int>, Split> kept;
+        for (int index = 0; index < candidates.getNumSegments(); index++){
+            const Segment &segment = candidates[index];
+            std::pair<int, int> key(segment.end + this -> offset, segment.start + this -> offset);
+            std::map<std::pair<int, int>, Split>::iterator it = this -> splits.find(key);
+            if (it != this -> splits.end()) kept.insert(*it);
+        }
+        this -> splits.swap(kept);
+    }
+
+    void clear(){
+        this -> splits.clear();
+    }
+
+    int size(){
+        return this -> splits.size();
+    }
+};
+
+#endif // BINSEG_SEGMENT_CACHE_H
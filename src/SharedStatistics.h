@@ -0,0 +1,72 @@
+#ifndef BINSEG_SHARED_STATISTICS_H
+#define BINSEG_SHARED_STATISTICS_H
+
+#include <mutex>
+#include "DistributionInterface.h"
+
+/**
+ * Summary statistics of a series that are computed once and then shared by the distributions of many runs, for instance
+ * to compare several distributions or minimum segment lengths on the same data. The statistics are only read by the
+ * distributions, so they can be used by several runs at the same time. Since each distribution requires either the
+ * linear or the quadratic sums, and the stable sums are only centered for the shift invariant distributions (see
+ * Cumsum::setStable), one variant is built for each combination, the first time that a distribution requires it.
+ * Then, the runs produce exactly the same models as with statistics of their own.
+ */
+class SharedStatistics {
+
+private:
+
+    bool stable;
+    StorageType storage;
+    bool runs, bounded;
+    int length = -1; // The length of the data, once the first variant is built
+    std::shared_ptr<Cumsum> variants[4]; // Indexed by 2 * squared + centered
+    std::mutex mutex;
+
+public:
+
+    /**
+     * Creates the shared statistics, without computing any variant yet.
+     * @param stable Whether to use the stable summary statistics (see Cumsum::setStable).
+     * @param storage The encoding of the prefix sums (see PrefixSums).
+     * @param runs Whether the sums are stored once per run (see Cumsum::useRuns).
+     * @param bounded Whether to build the bounds of the pruned search (see Cumsum::useBounds).
+     */
+    SharedStatistics(bool stable, StorageType storage, bool runs, bool bounded){
+        this -> stable = stable;
+        this -> storage = storage;
+        this -> runs = runs;
+        this -> bounded = bounded;
+    }
+
+    /**
+     * Sets the summary statistics of the distribution to the variant that it requires, which is computed from the data
+     * if it does not exist yet. The data must be the same for every distribution.
+     * @param dist The distribution, which may have no summary statistics yet.
+     * @param data The data
+     * @param length The length of the data
+     */
+    void attach(Distribution * dist, const double * data, int length){
+        std::lock_guard<std::mutex> lock(this -> mutex);
+        if (this -> length >= 0 && this -> length != length) throw "The data does not match the summary statistics";
+        dist -> setCumsum(); // Only to find the kind of summary statistics of the distribution, it is still empty
+        if (dynamic_cast<MultiCumsum *>(dist -> summaryStatistics.get()) != nullptr)
+            throw "The shared statistics are only available for the univariate distributions";
+        bool squared = dynamic_cast<CumsumSquared *>(dist -> summaryStatistics.get()) != nullptr;
+        bool centered = this -> stable && dist -> isShiftInvariant();
+        std::shared_ptr<Cumsum> &variant = this -> variants[2 * squared + centered];
+        if (variant != nullptr){
+            dist -> shareData(variant, data, length);
+            return;
+        }
+        if (this -> stable) dist -> useStableSums();
+        dist -> summaryStatistics -> setStorage(this -> storage);
+        if (this -> runs) dist -> summaryStatistics -> useRuns();
+        if (this -> bounded) dist -> summaryStatistics -> useBounds();
+        dist -> setData(data, length);
+        variant = dist -> summaryStatistics;
+        this -> length = length;
+    }
+};
+
+#endif // BINSEG_SHARED_STATISTICS_H
@@ -0,0 +1,92 @@
+#ifndef BINSEG_SPLIT_BOUNDS_H
+#define BINSEG_SPLIT_BOUNDS_H
+
+#include <math.h>
+#include "SplitScan.h"
+
+/**
+ * Lower bounds of the closed-form split costs over a block of consecutive candidate splits, so that the blocks that
+ * cannot improve the best split found so far are skipped without evaluating them (see CostKernel). The first half of
+ * the candidates of a block has length n between nFirst and nLast, and linear sum L = D + slope * n, where slope is the
+ * mean of the segment and D is its deviation, which lies in a range given by BlockHulls. The split cost is concave in
+ * (L, n) for MEAN_NORM_COST and POISSON_COST, so its minimum over the parallelogram spanned by those ranges is at one of
+ * its vertices.
+ */
+class SplitBounds {
+
+public:
+
+    /**
+     * @return Whether there is a bound for the given split cost.
+     */
+    static bool available(SplitCost C){
+        return C == MEAN_NORM_COST || C == POISSON_COST;
+    }
+
+    /**
+     * Computes the lower bound of the split cost of a segment over a block of candidates. For POISSON_COST, the
+     * parallelogram is first clipped to 0 <= L <= total, since the cost of the candidates outside of it is undefined,
+     * and they are never selected.
+     * @param total The linear sum of the segment.
+     * @param length The length of the segment.
+     * @param nFirst The length of the first half for the first candidate of the block.
+     * @param nLast The length of the first half for the last candidate of the block.
+     * @param dMin The minimum deviation of the candidates of the block.
+     * @param dMax The maximum deviation of the candidates of the block.
+     * @return The lower bound, which is INFINITY if no candidate of the block can be selected.
+     */
+    template<SplitCost C>
+    static double lower(double total, double length, double nFirst, double nLast, double dMin, double dMax){
+        double slope = total / length;
+        double n[8] = {nFirst, nLast, nLast, nFirst};
+        double L[8] = {dMin + slope * nFirst, dMin + slope * nLast, dMax + slope * nLast, dMax + slope * nFirst};
+        int count = 4;
+        if (C == POISSON_COST){
+            count = clip(n, L, count, 0, 1);
+            count = clip(n, L, count, total, -1);
+        }
+        double bound = INFINITY;
+        for (int k = 0; k < count; k++)
+            bound = fmin(bound, segmentCost<C>(L[k], n[k]) + segmentCost<C>(total - L[k], length - n[k]));
+        return bound;
+    }
+
+private:
+
+    /**
+     * The cost of a segment as in the corresponding DISTRIBUTION, extended to its limit when the sum is null.
+     */
+    template<SplitCost C>
+    static double segmentCost(double lSum, double N){
+        if (C == MEAN_NORM_COST) return - (lSum * lSum) / N;
+        if (lSum <= 0) return 0;
+        return - lSum * (log(lSum) - log(N));
+    }
+
+    // Clips the polygon to the half-plane sign * (L - level) >= 0 (Sutherland-Hodgman), and returns its new size.
+    static int clip(double * n, double * L, int count, double level, int sign){
+        double clippedN[8], clippedL[8];
+        int clipped = 0;
+        for (int k = 0; k < count; k++){
+            int next = (k + 1) % count;
+            bool inside = sign * (L[k] - level) >= 0;
+            bool nextInside = sign * (L[next] - level) >= 0;
+            if (inside){
+                clippedN[clipped] = n[k];
+                clippedL[clipped++] = L[k];
+            }
+            if (inside != nextInside){
+                double t = (level - L[k]) / (L[next] - L[k]);
+                clippedN[clipped] = n[k] + t * (n[next] - n[k]);
+                clippedL[clipped++] = level;
+            }
+        }
+        for (int k = 0; k < clipped; k++){
+            n[k] = clippedN[k];
+            L[k] = clippedL[k];
+        }
+        return clipped;
+    }
+};
+
+#endif // BINSEG_SPLIT_BOUNDS_H
@@ -0,0 +1,368 @@
+#ifndef BINSEG_SPLIT_SCAN_H
+#define BINSEG_SPLIT_SCAN_H
+
+#include <cfloat>
+#include <math.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BINSEG_SIMD_DISPATCH
+#endif
+
+/**
+ * The closed-form split costs that have a vectorized implementation. A distribution declares which one it uses through
+ * its static splitCost member, and NO_SPLIT_COST means that only the scalar CostKernel scan is available.
+ */
+enum SplitCost {NO_SPLIT_COST, MEAN_NORM_COST, MEANVAR_NORM_COST, POISSON_COST, EXPONENTIAL_COST};
+
+/**
+ * The instruction sets that the split scan can be dispatched to. The best one is selected at runtime.
+ */
+enum SimdLevel {SCALAR_LEVEL, AVX2_LEVEL, AVX512_LEVEL};
+
+#if defined(__GNUC__)
+// GCC vector extensions, so that the same expressions compile to AVX2 or AVX-512 instructions depending on the target
+// of the function they are inlined into.
+typedef double Double4 __attribute__((vector_size(4 * sizeof(double))));
+#else
+// Without the vector extensions, the four lanes are a plain array with the element-wise operators used by MultiCumsum.
+struct Double4 {
+    double lanes[4];
+
+    double & operator[](int k){
+        return this -> lanes[k];
+    }
+
+    double operator[](int k) const {
+        return this -> lanes[k];
+    }
+
+    Double4 & operator+=(const Double4 &other){
+        for (int k = 0; k < 4; k++) this -> lanes[k] += other.lanes[k];
+        return *this;
+    }
+
+    Double4 & operator-=(const Double4 &other){
+        for (int k = 0; k < 4; k++) this -> lanes[k] -= other.lanes[k];
+        return *this;
+    }
+
+    Double4 & operator*=(const Double4 &other){
+        for (int k = 0; k < 4; k++) this -> lanes[k] *= other.lanes[k];
+        return *this;
+    }
+};
+
+inline Double4 operator+(Double4 a, const Double4 &b){ return a += b; }
+inline Double4 operator-(Double4 a, const Double4 &b){ return a -= b; }
+inline Double4 operator*(Double4 a, const Double4 &b){ return a *= b; }
+#endif
+
+#ifdef BINSEG_SIMD_DISPATCH
+typedef long long Mask4 __attribute__((vector_size(4 * sizeof(double))));
+typedef double Double8 __attribute__((vector_size(8 * sizeof(double))));
+typedef long long Mask8 __attribute__((vector_size(8 * sizeof(double))));
+
+template<int W> struct SimdLanes;
+template<> struct SimdLanes<4> { typedef Double4 Vec; typedef Mask4 Mask; };
+template<> struct SimdLanes<8> { typedef Double8 Vec; typedef Mask8 Mask; };
+
+#define SCAN_INLINE inline __attribute__((always_inline))
+#endif
+
+/**
+ * Vectorized argmin of the split cost over the prefix sums. Every lane of a vector evaluates a different split point,
+ * so that 4 (AVX2) or 8 (AVX-512) candidates are processed at the same time. The prefix sums are read directly, with
+ * the origin at index -1, and the start > end branch of Cumsum::getLinearSum is hoisted out of the loop. The cost of
+ * mean_norm is written in the same order as its scalar cost function, so the selected split and its cost are identical
+ * to the ones of the scalar scan. The other costs take a single logarithm per segment (of the ratio of the sums for
+ * poisson and exponential), which is evaluated in the lanes with an error below 1 ulp (see laneLog). Then, their costs
+ * differ from the ones of the scalar scan by a few ulps, and so does the selected split only if two candidates are
+ * that close. The candidates after the last complete vector are evaluated in the first lane of a vector, so that every
+ * candidate of a scan is evaluated in the same way.
+ */
+class SplitScan {
+
+public:
+
+    /**
+     * Detects the best instruction set supported by the CPU. The result is computed only once, and it is never above
+     * the limit (see limit).
+     * @return The SimdLevel to be used by the scan.
+     */
+    static SimdLevel level(){
+        static SimdLevel detected = detect();
+        return detected < maximum() ? detected : maximum();
+    }
+
+    /**
+     * Limits the instruction set used by the scan, so that the vectorized scan can be compared with the scalar one.
+     * @param highest The highest SimdLevel to be used. SCALAR_LEVEL disables the vectorized scan.
+     */
+    static void limit(SimdLevel highest){
+        maximum() = highest;
+    }
+
+    /**
+     * Scans the candidate splits between first and last of the segment [start, end] with the best available
+     * instruction set. It follows the same semantics as Distribution::scanSplits.
+     * @tparam C The closed-form cost to be evaluated.
+     * @param linear The linear cumulative sum
+     * @param quadratic The quadratic cumulative sum, only read by MEANVAR_NORM_COST.
+     * @param start inclusive
+     * @param end inclusive
+     * @param first The first candidate split, must be at least start.
+     * @param last The last candidate split, must be smaller than end.
+     * @param mid Output parameter with the best split.
+     * @param bestSplitCost Output parameter with the cost of the best split.
+     * @return false if no vectorized scan is available, in which case the scalar scan must be used.
+     */
+    template<SplitCost C>
+    static bool scan(const double * linear, const double * quadratic, int start, int end, int first, int last,
+                     int &mid, double &bestSplitCost){
+#ifdef BINSEG_SIMD_DISPATCH
+        switch (level()) {
+            case AVX512_LEVEL:
+                bestSplitCost = scanAvx512<C>(linear, quadratic, start, end, first, last, mid);
+                return true;
+            case AVX2_LEVEL:
+                bestSplitCost = scanAvx2<C>(linear, quadratic, start, end, first, last, mid);
+                return true;
+            default:
+                break;
+        }
+#endif
+        (void) linear; (void) quadratic; (void) start; (void) end; (void) first; (void) last; (void) mid;
+        (void) bestSplitCost;
+        return false;
+    }
+
+private:
+
+    static SimdLevel &maximum(){
+        static SimdLevel level = AVX512_LEVEL;
+        return level;
+    }
+
+    static SimdLevel detect(){
+#ifdef BINSEG_SIMD_DISPATCH
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) return AVX512_LEVEL;
+        if (__builtin_cpu_supports("avx2")) return AVX2_LEVEL;
+#endif
+        return SCALAR_LEVEL;
+    }
+
+#ifdef BINSEG_SIMD_DISPATCH
+    // The following helpers take vectors only by reference, since they are compiled for the default target before
+    // being inlined.
+
+    template<class V>
+    static SCAN_INLINE void splat(V &v, double x){
+        for (unsigned k = 0; k < sizeof(V) / sizeof(double); k++) v[k] = x;
+    }
+
+    template<class V, class M>
+    static SCAN_INLINE void select(V &v, const M &mask, const V &ifTrue){
+        v = (V) ((mask & (M) ifTrue) | (~mask & (M) v));
+    }
+
+    /**
+     * The natural logarithm of every lane, as in __ieee754_log of fdlibm: x = 2^k * (1 + f) with sqrt(2)/2 < 1 + f <
+     * sqrt(2), and log(1 + f) = f - (f^2 / 2 - s * (f^2 / 2 + R(s^2))), where s = f / (2 + f) and R is a polynomial
+     * of degree 7. Its error is below 1 ulp. The subnormal lanes are scaled by 2^52 first, and the lanes that are zero,
+     * negative, infinite or NaN get the same special values as with the standard library, without any branch.
+     */
+    template<class V>
+    static SCAN_INLINE void laneLog(V &x){
+        typedef typename SimdLanes<sizeof(V) / sizeof(double)>::Mask M;
+        const double ln2Hi = 6.93147180369123816490e-01, ln2Lo = 1.90821492927058770002e-10;
+        const double Lg1 = 6.666666666666735130e-01, Lg2 = 3.999999999940941908e-01, Lg3 = 2.857142874366239149e-01,
+                     Lg4 = 2.222219843214978396e-01, Lg5 = 1.818357216161805012e-01,
+                     Lg6 = 1.531383769920937332e-01, Lg7 = 1.479819860511658591e-01;
+        const double twoTo52 = 4503599627370496.0;
+        M subnormal = (M) (x < DBL_MIN);
+        V scaled = x * twoTo52, shift, special;
+        select(scaled, ~subnormal, x);
+        splat(shift, 0.0);
+        splat(special, 52.0);
+        select(shift, subnormal, special);
+
+        M bits = (M) scaled;
+        M exponent = (bits >> 52) & 0x7FF;
+        V m = (V) ((bits & 0x000FFFFFFFFFFFFFLL) | 0x3FF0000000000000LL); // In [1, 2)
+        M large = (M) (m > M_SQRT2);
+        V halved = m * 0.5;
+        select(m, large, halved);
+        exponent -= large; // The lanes of a mask are -1 where it is true
+        V base;
+        splat(base, twoTo52);
+        V k = ((V) (exponent | (M) base) - base) - (1023.0 + shift); // The exponent is exact below 2^52
+
+        V f = m - 1.0;
+        V s = f / (2.0 + f);
+        V z = s * s;
+        V w = z * z;
+        V t1 = w * (Lg2 + w * (Lg4 + w * Lg6));
+        V t2 = z * (Lg1 + w * (Lg3 + w * (Lg5 + w * Lg7)));
+        V R = t2 + t1;
+        V hfsq = 0.5 * f * f;
+        V result = k * ln2Hi - ((hfsq - (s * (hfsq + R) + k * ln2Lo)) - f);
+
+        splat(special, -INFINITY);
+        select(result, (M) (x == 0), special);
+        splat(special, INFINITY);
+        select(result, (M) (x == INFINITY), special);
+        splat(special, NAN);
+        select(result, (M) (x < 0) | (M) (x != x), special);
+        x = result;
+    }
+
+    template<class V>
+    static SCAN_INLINE void infIfNonPositive(V &cost, const V &varN){
+        typedef typename SimdLanes<sizeof(V) / sizeof(double)>::Mask M;
+        V infinity;
+        splat(infinity, INFINITY);
+        select(cost, (M) (varN <= 0), infinity);
+    }
+
+    /**
+     * The cost of a single segment given its sums and length, written as in the corresponding DISTRIBUTION.
+     */
+    template<SplitCost C, class V>
+    static SCAN_INLINE void segmentCost(V &cost, const V &lSum, const V &sSum, const V &N){
+        V logA, logB;
+        switch (C) {
+            case MEAN_NORM_COST:
+                cost = - (lSum * lSum) / N;
+                break;
+            case MEANVAR_NORM_COST:
+                logA = 1.0 / N;
+                logB = sSum - (lSum * lSum * logA); // varN
+                logA = logB * logA;
+                laneLog(logA);
+                cost = N * (logA + log(2 * M_PI) + 1);
+                infIfNonPositive(cost, logB);
+                break;
+            case POISSON_COST:
+                logA = lSum / N; // A single logarithm, of the ratio
+                laneLog(logA);
+                cost = - lSum * logA;
+                break;
+            case EXPONENTIAL_COST:
+                logA = N / lSum;
+                laneLog(logA);
+                cost = - N * logA;
+                break;
+            default:
+                splat(cost, INFINITY);
+        }
+    }
+
+    /**
+     * The cost of splitting [start, end] at the points of the lanes, given the prefix sums at those points.
+     */
+    template<SplitCost C, class V>
+    static SCAN_INLINE void splitCost(V &cost, const V &linearAt, const V &quadraticAt, const V &leftN,
+                                      const V &rightN, double linearBase, double quadraticBase, double linearEnd,
+                                      double quadraticEnd){
+        V first, second;
+        segmentCost<C>(first, linearAt - linearBase, quadraticAt - quadraticBase, leftN);
+        segmentCost<C>(second, linearEnd - linearAt, quadraticEnd - quadraticAt, rightN);
+        cost = first + second;
+    }
+
+    /**
+     * The scan itself, for vectors of W lanes. It must be inlined into a function compiled for the instruction set.
+     */
+    template<int W, SplitCost C>
+    static SCAN_INLINE double scanLanes(const double * linear, const double * quadratic, int start, int end, int first,
+                                        int last, int &mid){
+        typedef typename SimdLanes<W>::Vec V;
+        typedef typename SimdLanes<W>::Mask M;
+
+        const bool useQuadratic = C == MEANVAR_NORM_COST;
+        const double linearBase = linear[start - 1]; // The origin of the prefix sums if start == 0 (see PrefixSums)
+        const double quadraticBase = useQuadratic ? quadratic[start - 1] : 0;
+        const double linearEnd = linear[end];
+        const double quadraticEnd = useQuadratic ? quadratic[end] : 0;
+
+        V lanes, bestLanes, linearAt = V(), quadraticAt = V(), curr = V();
+        M laneIndex, bestIndex;
+        for (int k = 0; k < W; k++){
+            lanes[k] = k;
+            laneIndex[k] = k;
+            bestLanes[k] = DBL_MAX;
+            bestIndex[k] = -1;
+        }
+
+        int i = first;
+        for (; i + W - 1 <= last; i += W){
+            __builtin_memcpy(&linearAt, linear + i, sizeof(V));
+            if (useQuadratic) __builtin_memcpy(&quadraticAt, quadratic + i, sizeof(V));
+            V leftN = lanes + (double) (i - start + 1);
+            V rightN = (double) (end - i) - lanes;
+            splitCost<C>(curr, linearAt, quadraticAt, leftN, rightN, linearBase, quadraticBase, linearEnd,
+                         quadraticEnd);
+            M infinite = (M) (curr == INFINITY);
+            M improves = (M) (curr < bestLanes);
+            long long anyInfinite = 0;
+            for (int k = 0; k < W; k++) anyInfinite |= infinite[k];
+            if (anyInfinite){
+                mid = 0;
+                return INFINITY;
+            }
+            M index = laneIndex + (long long) i;
+            select(bestLanes, improves, curr);
+            bestIndex = (improves & index) | (~improves & bestIndex);
+        }
+
+        double bestSplitCost = DBL_MAX;
+        long long bestSplit = -1;
+        for (int k = 0; k < W; k++){
+            if (bestIndex[k] < 0) continue;
+            if (bestLanes[k] < bestSplitCost || (bestLanes[k] == bestSplitCost && bestIndex[k] < bestSplit)){
+                bestSplitCost = bestLanes[k];
+                bestSplit = bestIndex[k];
+            }
+        }
+
+        for (; i <= last; i++){
+            V leftN, rightN;
+            splat(linearAt, linear[i]);
+            if (useQuadratic) splat(quadraticAt, quadratic[i]);
+            splat(leftN, (double) (i - start + 1));
+            splat(rightN, (double) (end - i));
+            splitCost<C>(curr, linearAt, quadraticAt, leftN, rightN, linearBase, quadraticBase, linearEnd,
+                         quadraticEnd);
+            double currSplitCost = curr[0];
+            if (currSplitCost == INFINITY){
+                mid = 0;
+                return INFINITY;
+            }
+            if (currSplitCost < bestSplitCost){
+                bestSplitCost = currSplitCost;
+                bestSplit = i;
+            }
+        }
+
+        if (bestSplit >= 0) mid = (int) bestSplit;
+        return bestSplitCost;
+    }
+
+    template<SplitCost C>
+    __attribute__((target("avx2")))
+    static double scanAvx2(const double * linear, const double * quadratic, int start, int end, int first, int last,
+                           int &mid){
+        return scanLanes<4, C>(linear, quadratic, start, end, first, last, mid);
+    }
+
+    template<SplitCost C>
+    __attribute__((target("avx512f,avx512dq")))
+    static double scanAvx512(const double * linear, const double * quadratic, int start, int end, int first,
+                             int last, int &mid){
+        return scanLanes<8, C>(linear, quadratic, start, end, first, last, mid);
+    }
+#endif
+};
+
+#endif // BINSEG_SPLIT_SCAN_H
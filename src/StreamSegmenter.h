@@ -0,0 +1,133 @@
+#ifndef BINSEG_STREAM_SEGMENTER_H
+#define BINSEG_STREAM_SEGMENTER_H
+
+#include "AlgorithmInterface.h"
+#include "DistributionInterface.h"
+#include "SegmentCache.h"
+#include <deque>
+
+/**
+ * Stateful segmentation of a stream of data. The observations are appended to the summary statistics of the
+ * distribution, without computing them again from the start. Since the data of a segment does not change when new
+ * observations arrive, only the segments that reach the new end of the data must be scanned (unless the cost of the
+ * distribution depends on the whole data, in which case every segment is scanned again). If the algorithm can extend
+ * its previous run (see Algorithm::extend), its candidates queue and models are kept, and only the models that change
+ * are computed again. Otherwise, every run of the algorithm reuses the optimal partitions of the segments that were
+ * already evaluated.
+ *
+ * The stream can also keep only a sliding window of its last observations (see setWindow). The oldest observations are
+ * then removed from the summary statistics in constant time instead of computing them again for every window, so each
+ * run only costs the scans of the segments that changed.
+ */
+class StreamSegmenter {
+
+private:
+
+    std::shared_ptr<Distribution> dist;
+    std::shared_ptr<Algorithm> algo;
+    std::shared_ptr<SegmentCache> cache;
+    int length, numCpts, minSegLen;
+    int window = 0; // The maximum number of observations kept, or 0 to keep all of them
+    std::deque<double> recent; // The observations in the window, whose constant terms are removed with them
+    bool slid = false; // Whether observations were removed from the start since the last run
+
+    /**
+     * Removes the oldest observations from the window.
+     * @param count The number of observations to remove
+     */
+    void slide(int count){
+        std::vector<double> removed(this -> recent.begin(), this -> recent.begin() + count);
+        this -> dist -> popData(removed.data(), count);
+        this -> recent.erase(this -> recent.begin(), this -> recent.begin() + count);
+        if (this -> dist -> hasLocalCost()) this -> cache -> slide(count);
+        else this -> cache -> clear();
+        this -> length -= count;
+        this -> slid = true;
+    }
+
+public:
+
+    /**
+     * Creates an empty stream.
+     * @param algorithm The name of the algorithm, as registered in AlgorithmFactory.
+     * @param distribution The name of the distribution, as registered in DistributionFactory.
+     * @param numCpts The number of changepoints to be computed on each run.
+     * @param minSegLen The minimum segment length.
+     * @param stableSums Whether to use the stable summary statistics (see Cumsum::setStable).
+     */
+    StreamSegmenter(std::string algorithm, std::string distribution, int numCpts, int minSegLen, bool stableSums){
+        this -> dist = DistributionFactory::Create(distribution);
+        this -> algo = AlgorithmFactory::Create(algorithm);
+        this -> cache = std::make_shared<SegmentCache>();
+        this -> dist -> setCumsum();
+        if (stableSums) this -> dist -> useStableSums();
+        this -> algo -> dist = this -> dist;
+        this -> algo -> cache = this -> cache;
+        this -> length = 0;
+        this -> numCpts = numCpts;
+        this -> minSegLen = minSegLen;
+    }
+
+    /**
+     * Keeps only the last observations of the stream, so that every run segments a sliding window. The indices of the
+     * models then start at the first observation of the window. It must be called before the data is appended.
+     * @param window The maximum number of observations kept, or 0 to keep all of them.
+     */
+    void setWindow(int window){
+        if (window < 0) throw "The window must have a non-negative length";
+        this -> window = window;
+    }
+
+    /**
+     * Appends new observations to the stream. The cached segments that end at the previous last observation are
+     * discarded, since they are unlikely to be created again. If a window is used, the observations that leave it are
+     * removed afterwards.
+     * @param data The new observations
+     * @param count The number of new observations
+     */
+    void append(const double * data, int count){
+        this -> dist -> appendData(data, count);
+        if (this -> dist -> hasLocalCost()) this -> cache -> discardFrom(this -> length - 1);
+        else this -> cache -> clear();
+        this -> length += count;
+        if (this -> window == 0) return;
+        this -> recent.insert(this -> recent.end(), data, data + count);
+        if (this -> length > this -> window) this -> slide(this -> length - this -> window);
+    }
+
+    /**
+     * Runs the algorithm over all the observations of the stream, extending the previous run unless the window slid
+     * since then. The models are available through getModels. Only the cached segments of this run are kept.
+     */
+    void segment(){
+        bool extended = !this -> slid && this -> algo -> extend(this -> length);
+        this -> slid = false;
+        if (!extended){
+            this -> algo -> prepare(this -> length, this -> numCpts, this -> dist, this -> minSegLen);
+            this -> algo -> run();
+        }
+        this -> cache -> retain(this -> algo -> candidates);
+    }
+
+    ModelTable & getModels(){
+        return this -> algo -> models;
+    }
+
+    int getLength(){
+        return this -> length;
+    }
+
+    int getCacheSize(){
+        return this -> cache -> size();
+    }
+
+    std::vector<std::string> getParamNames(){
+        return this -> algo -> getParamNames();
+    }
+
+    void setRandomIntervals(int numIntervals, int seed){
+        this -> algo -> setRandomIntervals(numIntervals, seed);
+    }
+};
+
+#endif // BINSEG_STREAM_SEGMENTER_H
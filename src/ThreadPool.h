@@ -0,0 +1,127 @@
+#ifndef BINSEG_THREAD_POOL_H
+#define BINSEG_THREAD_POOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <deque>
+#include <vector>
+
+/**
+ * A fixed size pool of worker threads that executes batches of independent tasks. The thread that submits a batch also
+ * executes queued tasks while it waits, so that batches can be nested (i.e. a parallel scan inside the concurrent
+ * evaluation of two segments) without running out of workers. No R API must be called from the tasks.
+ */
+class ThreadPool {
+
+private:
+
+    struct Batch {
+        const std::function<void(int)> * task;
+        int remaining;
+        std::exception_ptr error;
+    };
+
+    struct Job {
+        Batch * batch;
+        int index;
+    };
+
+    std::vector<std::thread> workers;
+    std::deque<Job> queue;
+    std::mutex mutex;
+    std::condition_variable available, finished;
+    bool stopping;
+
+public:
+
+    /**
+     * Creates the pool. The calling thread counts as one of the threads, so only numThreads - 1 workers are spawned.
+     * @param numThreads The total number of threads that execute tasks.
+     */
+    explicit ThreadPool(int numThreads){
+        this -> stopping = false;
+        for (int i = 1; i < numThreads; i++) this -> workers.emplace_back(&ThreadPool::work, this);
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ThreadPool& operator = (const ThreadPool&) = delete;
+
+    /**
+     * Stops and joins every worker. Pending batches must have finished, which is guaranteed since parallelFor blocks.
+     */
+    ~ThreadPool(){
+        {
+            std::lock_guard<std::mutex> lock(this -> mutex);
+            this -> stopping = true;
+        }
+        this -> available.notify_all();
+        for (std::thread &worker: this -> workers) worker.join();
+    }
+
+    int size(){
+        return this -> workers.size() + 1;
+    }
+
+    /**
+     * Executes task(0), ..., task(count - 1) in parallel and blocks until all of them are finished. If any of the tasks
+     * throws, the first exception is rethrown in the calling thread once the whole batch is done.
+     * @param count The number of tasks
+     * @param task The function to execute, which receives the index of the task.
+     */
+    void parallelFor(int count, const std::function<void(int)> &task){
+        if (count <= 0) return;
+        if (this -> workers.empty() || count == 1){
+            for (int i = 0; i < count; i++) task(i);
+            return;
+        }
+        Batch batch = {&task, count, nullptr};
+        std::unique_lock<std::mutex> lock(this -> mutex);
+        for (int i = 0; i < count; i++) this -> queue.push_back({&batch, i});
+        this -> available.notify_all();
+        while (batch.remaining > 0){
+            if (this -> queue.empty()){
+                this -> finished.wait(lock);
+                continue;
+            }
+            Job job = this -> queue.front();
+            this -> queue.pop_front();
+            this -> run(job, lock);
+        }
+        if (batch.error) std::rethrow_exception(batch.error);
+    }
+
+private:
+
+    /**
+     * Runs a job outside of the lock, and records its completion (and exception, if any) in its batch.
+     */
+    void run(Job job, std::unique_lock<std::mutex> &lock){
+        lock.unlock();
+        std::exception_ptr error = nullptr;
+        try {
+            (*job.batch -> task)(job.index);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+        if (error && !job.batch -> error) job.batch -> error = error;
+        if (--job.batch -> remaining == 0) this -> finished.notify_all();
+    }
+
+    void work(){
+        std::unique_lock<std::mutex> lock(this -> mutex);
+        while (true){
+            this -> available.wait(lock, [this]{ return this -> stopping || !this -> queue.empty(); });
+            if (this -> queue.empty()) return;
+            Job job = this -> queue.front();
+            this -> queue.pop_front();
+            this -> run(job, lock);
+        }
+    }
+};
+
+#endif // BINSEG_THREAD_POOL_H